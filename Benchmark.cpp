@@ -0,0 +1,607 @@
+// === File: Benchmark.cpp ===
+// Headless benchmark: runs DelayFilterPluginAudioProcessor::processBlock (no editor) for every
+// filterType / IIR type across block sizes, sample rates, tap counts and oversampling factors, and prints
+// ns/sample, realtime factor and p99 block time as JSON.
+//
+//   DelayFilterBenchmark [--quick] [--seconds <audio seconds per case>] [--channels 2,6,16]
+//                        [--precision float,double] [--output <file.json>]
+//
+// --record / --verify instead render impulse, sweep and noise through the --quick cases and
+// write or check golden WAVs in <dir>; --verify exits with 1 if any output drifts from its
+// golden by more than the tolerance recorded with them, or splitting the buffer into other
+// block sizes changes it. --record-budgets / --check-budgets do the same for per-case
+// ns/sample budgets, which only hold on the machine that recorded them; elsewhere the check
+// exits with 77, which ctest reports as skipped.
+//
+//   DelayFilterBenchmark --record <dir> | --verify <dir> [--tolerance 1e-4]
+//   DelayFilterBenchmark --record-budgets <dir> | --check-budgets <dir> [--margin 0.25]
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include <chrono>
+
+namespace
+{
+    struct BenchCase
+    {
+        juce::String mode, variant;
+        std::vector<std::pair<juce::String, float>> params;
+        bool silentInput{ false };
+    };
+
+    struct BenchResult
+    {
+        double nsPerSample{ 0.0 }, realtimeFactor{ 0.0 }, meanBlockNs{ 0.0 }, p99BlockNs{ 0.0 }, maxBlockNs{ 0.0 };
+        int numBlocks{ 0 };
+    };
+
+    void setParameter(DelayFilterPluginAudioProcessor& processor, const juce::String& id, float value)
+    {
+        if (auto* param = processor.apvts.getParameter(id))
+            param->setValueNotifyingHost(param->convertTo0to1(value));
+    }
+
+    std::vector<BenchCase> makeCases(bool quick)
+    {
+        std::vector<BenchCase> cases;
+
+        cases.push_back({ "Comb", "feedback=0.7", { { "filterType", 0.0f }, { "feedback", 0.7f } } });
+        cases.push_back({ "Comb", "silence", { { "filterType", 0.0f }, { "feedback", 0.7f } }, true });
+
+        const std::vector<int> tapCounts = quick ? std::vector<int>{ 16, 256 } : std::vector<int>{ 2, 16, 64, 65, 256, 1024 };
+        for (auto taps : tapCounts)
+            cases.push_back({ "FIR", "taps=" + juce::String(taps), { { "filterType", 1.0f }, { "taps", static_cast<float>(taps) }, { "tapGain", 0.5f } } });
+
+        const juce::StringArray iirTypes{ "LowPass", "HighPass", "BandPass" };
+        for (int type = 0; type < iirTypes.size(); ++type)
+            for (int slope = 0; slope < 2; ++slope)
+                cases.push_back({ "IIR", iirTypes[type] + (slope == 0 ? "/12dB" : "/24dB"),
+                                  { { "filterType", 2.0f }, { "iirType", static_cast<float>(type) }, { "iirSlope", static_cast<float>(slope) }, { "iirQ", 2.0f } } });
+
+        cases.push_back({ "Phaser", "feedback=0.7", { { "filterType", 3.0f }, { "feedback", 0.7f } } });
+
+        // phaserStages is a choice index into { 2, 4, 8, 12 }
+        const std::vector<int> stageChoices = quick ? std::vector<int>{ 3 } : std::vector<int>{ 1, 2, 3 };
+        for (auto choice : stageChoices)
+            cases.push_back({ "Phaser", "stages=" + juce::String(choice == 3 ? 12 : 2 << choice) + "/spread=0.5",
+                              { { "filterType", 3.0f }, { "feedback", 0.7f }, { "phaserStages", static_cast<float>(choice) },
+                                { "phaserSpread", 0.5f }, { "phaserFeedback", 0.5f } } });
+        cases.push_back({ "Flanger", "feedback=0.7", { { "filterType", 4.0f }, { "feedback", 0.7f }, { "filterFreq", 500.0f } } });
+
+        const std::vector<int> oversamplingOrders = quick ? std::vector<int>{ 2 } : std::vector<int>{ 1, 2, 3 };
+        for (auto order : oversamplingOrders)
+        {
+            const auto variant = "feedback=0.7/" + juce::String(1 << order) + "x";
+            cases.push_back({ "Phaser", variant, { { "filterType", 3.0f }, { "feedback", 0.7f }, { "oversampling", static_cast<float>(order) } } });
+            cases.push_back({ "Flanger", variant, { { "filterType", 4.0f }, { "feedback", 0.7f }, { "filterFreq", 500.0f }, { "oversampling", static_cast<float>(order) } } });
+        }
+
+        // chainStage choices: 0 Off, 1 Comb, 2 FIR, 3 IIR, 4 Phaser, 5 Flanger; compare with the single-mode rows
+        cases.push_back({ "Chain", "comb>iir>flanger", { { "routing", 1.0f }, { "feedback", 0.7f }, { "filterFreq", 500.0f },
+                                                         { "chainStage1", 1.0f }, { "chainStage2", 3.0f }, { "chainStage3", 5.0f }, { "chainStage4", 0.0f } } });
+        if (! quick)
+            cases.push_back({ "Chain", "fir>phaser", { { "routing", 1.0f }, { "feedback", 0.7f }, { "taps", 64.0f }, { "tapGain", 0.5f },
+                                                       { "chainStage1", 2.0f }, { "chainStage2", 4.0f }, { "chainStage3", 0.0f }, { "chainStage4", 0.0f } } });
+
+        return cases;
+    }
+
+    template <typename SampleType>
+    BenchResult runCase(const BenchCase& benchCase, int numChannels, double sampleRate, int blockSize, double seconds)
+    {
+        DelayFilterPluginAudioProcessor processor;
+        for (const auto& [id, value] : benchCase.params)
+            setParameter(processor, id, value);
+
+        processor.setProcessingPrecision(std::is_same_v<SampleType, double> ? juce::AudioProcessor::doublePrecision
+                                                                            : juce::AudioProcessor::singlePrecision);
+        processor.setPlayConfigDetails(numChannels, numChannels, sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        // Noise input, so nothing is measured on the idle path, except for the case timing it
+        juce::AudioBuffer<SampleType> input(numChannels, blockSize), buffer(numChannels, blockSize);
+        input.clear();
+        juce::Random random(0x5eed);
+        for (int ch = 0; ch < numChannels && ! benchCase.silentInput; ++ch)
+            for (int i = 0; i < blockSize; ++i)
+                input.setSample(ch, i, static_cast<SampleType>(random.nextFloat() * 0.5f - 0.25f));
+        juce::MidiBuffer midi;
+
+        const int numBlocks = juce::jmax(16, static_cast<int>(seconds * sampleRate / blockSize));
+        const int warmupBlocks = juce::jmax(4, numBlocks / 10);
+        std::vector<double> blockNs;
+        blockNs.reserve(static_cast<size_t>(numBlocks));
+
+        for (int b = 0; b < warmupBlocks + numBlocks; ++b)
+        {
+            buffer.makeCopyOf(input, true);
+            const auto start = std::chrono::steady_clock::now();
+            processor.processBlock(buffer, midi);
+            const auto end = std::chrono::steady_clock::now();
+
+            if (b >= warmupBlocks)
+                blockNs.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+        }
+
+        processor.releaseResources();
+
+        BenchResult result;
+        result.numBlocks = numBlocks;
+        double total = 0.0;
+        for (auto ns : blockNs)
+            total += ns;
+
+        const double totalSamples = static_cast<double>(numBlocks) * blockSize;
+        result.nsPerSample = total / totalSamples;
+        result.meanBlockNs = total / numBlocks;
+        result.realtimeFactor = (totalSamples / sampleRate * 1.0e9) / total;
+
+        std::sort(blockNs.begin(), blockNs.end());
+        result.p99BlockNs = blockNs[static_cast<size_t>(std::ceil(0.99 * numBlocks)) - 1];
+        result.maxBlockNs = blockNs.back();
+        return result;
+    }
+
+    juce::var describeBuild()
+    {
+        auto* build = new juce::DynamicObject();
+        build->setProperty("juce", juce::SystemStats::getJUCEVersion());
+        build->setProperty("os", juce::SystemStats::getOperatingSystemName());
+        build->setProperty("cpu", juce::SystemStats::getCpuModel());
+        build->setProperty("cpuMHz", juce::SystemStats::getCpuSpeedInMegahertz());
+        build->setProperty("avx2", juce::SystemStats::hasAVX2());
+       #if JUCE_DEBUG
+        build->setProperty("config", "Debug");
+       #else
+        build->setProperty("config", "Release");
+       #endif
+        build->setProperty("timestamp", juce::Time::getCurrentTime().toISO8601(true));
+        return juce::var(build);
+    }
+
+    // Golden renders: stereo at 48 kHz, prepared for goldenBlockSize and fed the whole signal in
+    // one call (processBlock splits it), so the goldens pin the sub-block path as well
+    constexpr double goldenSampleRate = 48000.0;
+    constexpr int goldenChannels = 2, goldenBlockSize = 512, goldenLength = 8192;
+
+    // Block-split renders cycle through these; 1000 exceeds the prepared size on purpose
+    const std::vector<int> splitBlockSizes{ 1, 7, 64, 333, 1000, 2, 128 };
+
+    // Split renders only differ by the rounding of the LFO's interpolated segments
+    constexpr double splitTolerance = 1.0e-5;
+
+    enum class GoldenSignal { impulse, sweep, noise };
+
+    const char* getSignalName(GoldenSignal signal) noexcept
+    {
+        switch (signal)
+        {
+        case GoldenSignal::impulse: return "impulse";
+        case GoldenSignal::sweep:   return "sweep";
+        default:                    return "noise";
+        }
+    }
+
+    juce::AudioBuffer<float> makeGoldenInput(GoldenSignal signal)
+    {
+        juce::AudioBuffer<float> input(goldenChannels, goldenLength);
+        input.clear();
+
+        if (signal == GoldenSignal::impulse)
+        {
+            for (int ch = 0; ch < goldenChannels; ++ch)
+                input.setSample(ch, 0, 1.0f);
+        }
+        else if (signal == GoldenSignal::sweep)
+        {
+            // Exponential sine sweep, 20 Hz to 20 kHz over the whole signal
+            const double duration = goldenLength / goldenSampleRate;
+            const double k = std::log(20000.0 / 20.0);
+            for (int i = 0; i < goldenLength; ++i)
+            {
+                const double t = i / goldenSampleRate;
+                const double phase = juce::MathConstants<double>::twoPi * 20.0 * duration / k * (std::exp(t * k / duration) - 1.0);
+                for (int ch = 0; ch < goldenChannels; ++ch)
+                    input.setSample(ch, i, static_cast<float>(0.5 * std::sin(phase)));
+            }
+        }
+        else
+        {
+            juce::Random random(0x5eed);
+            for (int ch = 0; ch < goldenChannels; ++ch)
+                for (int i = 0; i < goldenLength; ++i)
+                    input.setSample(ch, i, random.nextFloat() - 0.5f);
+        }
+        return input;
+    }
+
+    // Fresh processor per render; with blockSizes, processBlock is called with those sizes in turn
+    juce::AudioBuffer<float> renderGolden(const BenchCase& benchCase, const juce::AudioBuffer<float>& input, const std::vector<int>& blockSizes)
+    {
+        DelayFilterPluginAudioProcessor processor;
+        for (const auto& [id, value] : benchCase.params)
+            setParameter(processor, id, value);
+
+        processor.setPlayConfigDetails(goldenChannels, goldenChannels, goldenSampleRate, goldenBlockSize);
+        processor.prepareToPlay(goldenSampleRate, goldenBlockSize);
+
+        juce::AudioBuffer<float> output;
+        output.makeCopyOf(input);
+        juce::MidiBuffer midi;
+
+        if (blockSizes.empty())
+        {
+            processor.processBlock(output, midi);
+        }
+        else
+        {
+            size_t next = 0;
+            for (int start = 0; start < goldenLength;)
+            {
+                const int n = juce::jmin(blockSizes[next++ % blockSizes.size()], goldenLength - start);
+                juce::AudioBuffer<float> block(output.getArrayOfWritePointers(), goldenChannels, start, n);
+                processor.processBlock(block, midi);
+                start += n;
+            }
+        }
+
+        processor.releaseResources();
+        return output;
+    }
+
+    // Largest absolute sample difference; infinite if the shapes differ
+    double getMaxDifference(const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b)
+    {
+        if (a.getNumChannels() != b.getNumChannels() || a.getNumSamples() != b.getNumSamples())
+            return std::numeric_limits<double>::infinity();
+
+        double maxDifference = 0.0;
+        for (int ch = 0; ch < a.getNumChannels(); ++ch)
+            for (int i = 0; i < a.getNumSamples(); ++i)
+                maxDifference = juce::jmax(maxDifference, std::abs(static_cast<double>(a.getSample(ch, i)) - b.getSample(ch, i)));
+        return maxDifference;
+    }
+
+    // 32-bit float WAV, so goldens are exact and can be auditioned when a check fails
+    bool writeWav(const juce::File& file, const juce::AudioBuffer<float>& buffer)
+    {
+        file.deleteFile();
+        std::unique_ptr<juce::FileOutputStream> stream = file.createOutputStream();
+        if (stream == nullptr || stream->failedToOpen())
+            return false;
+
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(stream.get(), goldenSampleRate, static_cast<unsigned int>(buffer.getNumChannels()),
+                                                                            32, {}, 0));
+        if (writer == nullptr)
+            return false;
+        stream.release(); // owned by the writer now
+
+        return writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples());
+    }
+
+    bool readWav(const juce::File& file, juce::AudioBuffer<float>& buffer)
+    {
+        if (! file.existsAsFile())
+            return false;
+
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatReader> reader(wav.createReaderFor(new juce::FileInputStream(file), true));
+        if (reader == nullptr)
+            return false;
+
+        buffer.setSize(static_cast<int>(reader->numChannels), static_cast<int>(reader->lengthInSamples));
+        return reader->read(&buffer, 0, buffer.getNumSamples(), 0, true, true);
+    }
+
+    juce::String getGoldenName(const BenchCase& benchCase, GoldenSignal signal)
+    {
+        return juce::File::createLegalFileName(benchCase.mode + "_" + benchCase.variant.replaceCharacters("/=>", "_--") + "_" + getSignalName(signal));
+    }
+
+    // A report line per check; returns the exit code for the checks made
+    struct GoldenReport
+    {
+        int checks{ 0 }, failures{ 0 };
+
+        void add(bool passed, const juce::String& name, const juce::String& detail)
+        {
+            ++checks;
+            if (! passed)
+                ++failures;
+            std::fprintf(stderr, "%s  %-44s %s\n", passed ? "ok  " : "FAIL", name.toRawUTF8(), detail.toRawUTF8());
+        }
+
+        int finish() const
+        {
+            std::fprintf(stderr, "%d checks, %d failed\n", checks, failures);
+            return failures == 0 ? 0 : 1;
+        }
+    };
+
+    // Exit code ctest treats as skipped (SKIP_RETURN_CODE in CMakeLists.txt)
+    constexpr int skippedExitCode = 77;
+
+    // --record writes goldens plus golden.json, which keeps the tolerance they are checked with;
+    // --verify checks against them. Returns the exit code: skippedExitCode if no golden has been
+    // recorded in the directory yet, while a set with some files missing fails.
+    int runGolden(const juce::File& directory, bool record, double tolerance)
+    {
+        if (record && ! directory.createDirectory())
+        {
+            std::fprintf(stderr, "Could not create %s\n", directory.getFullPathName().toRawUTF8());
+            return 1;
+        }
+
+        if (! record && directory.findChildFiles(juce::File::findFiles, false, "*.wav").isEmpty())
+        {
+            std::fprintf(stderr, "skipped: no goldens recorded in %s (run --record on a reference build)\n",
+                         directory.getFullPathName().toRawUTF8());
+            return skippedExitCode;
+        }
+
+        // An explicit --tolerance overrides the recorded one
+        const auto manifestFile = directory.getChildFile("golden.json");
+        if (! record && tolerance <= 0.0)
+            tolerance = static_cast<double>(juce::JSON::parse(manifestFile).getProperty("tolerance", 1.0e-4));
+        if (tolerance <= 0.0)
+            tolerance = 1.0e-4;
+
+        const auto failedDirectory = directory.getChildFile("failed");
+        GoldenReport report;
+
+        // The quick set is the golden set: changing it means recording again
+        for (const auto& benchCase : makeCases(true))
+        {
+            if (benchCase.silentInput)
+                continue;
+
+            for (auto signal : { GoldenSignal::impulse, GoldenSignal::sweep, GoldenSignal::noise })
+            {
+                const auto name = getGoldenName(benchCase, signal);
+                const auto input = makeGoldenInput(signal);
+                const auto output = renderGolden(benchCase, input, {});
+                const auto goldenFile = directory.getChildFile(name + ".wav");
+
+                if (record)
+                {
+                    report.add(writeWav(goldenFile, output), name, "recorded");
+                }
+                else
+                {
+                    juce::AudioBuffer<float> golden;
+                    if (! readWav(goldenFile, golden))
+                    {
+                        report.add(false, name, "no golden file");
+                    }
+                    else
+                    {
+                        const double difference = getMaxDifference(output, golden);
+                        const bool passed = difference <= tolerance;
+                        if (! passed && failedDirectory.createDirectory())
+                            writeWav(failedDirectory.getChildFile(name + ".wav"), output);
+                        report.add(passed, name, "max error " + juce::String(difference, 8));
+                    }
+                }
+
+                // State must carry across any split of the buffer; the impulse tail would also
+                // exercise the idle bypass, whose onset is only block-accurate
+                if (signal != GoldenSignal::impulse)
+                {
+                    const double difference = getMaxDifference(renderGolden(benchCase, input, splitBlockSizes), output);
+                    report.add(difference <= splitTolerance, name + " split", "max error " + juce::String(difference, 8));
+                }
+            }
+        }
+
+        if (record)
+        {
+            juce::DynamicObject::Ptr manifest = new juce::DynamicObject();
+            manifest->setProperty("schema", 1);
+            manifest->setProperty("tolerance", tolerance);
+            manifest->setProperty("sampleRate", goldenSampleRate);
+            manifest->setProperty("blockSize", goldenBlockSize);
+            if (! manifestFile.replaceWithText(juce::JSON::toString(juce::var(manifest.get()))))
+                report.add(false, manifestFile.getFileName(), "could not write");
+        }
+
+        return report.finish();
+    }
+
+    // The parts of describeBuild() that change how fast the same code runs
+    bool isSameMachine(const juce::var& recorded, const juce::var& current)
+    {
+        for (const auto* key : { "juce", "os", "cpu", "avx2", "config" })
+            if (recorded.getProperty(key, juce::var()).toString() != current.getProperty(key, juce::var()).toString())
+                return false;
+        return true;
+    }
+
+    // --record-budgets stores each golden case's ns/sample in budgets.json; --check-budgets fails
+    // any case slower than its budget by more than the margin. Budgets only mean something on
+    // the machine and build configuration that recorded them: anywhere else, or with none
+    // recorded, the check exits with skippedExitCode rather than passing.
+    int runBudgets(const juce::File& directory, bool record, double margin, double seconds)
+    {
+        if (record && ! directory.createDirectory())
+        {
+            std::fprintf(stderr, "Could not create %s\n", directory.getFullPathName().toRawUTF8());
+            return 1;
+        }
+
+        const auto budgetFile = directory.getChildFile("budgets.json");
+        const auto build = describeBuild();
+        juce::var storedBudgets;
+        if (! record)
+        {
+            const auto stored = juce::JSON::parse(budgetFile);
+            if (! stored.hasProperty("budgets") || ! isSameMachine(stored.getProperty("build", juce::var()), build))
+            {
+                std::fprintf(stderr, "skipped: no budgets recorded on this machine and build in %s\n", budgetFile.getFullPathName().toRawUTF8());
+                return skippedExitCode;
+            }
+            storedBudgets = stored.getProperty("budgets", juce::var());
+        }
+
+        juce::DynamicObject::Ptr budgets = new juce::DynamicObject();
+        GoldenReport report;
+
+        for (const auto& benchCase : makeCases(true))
+        {
+            if (benchCase.silentInput)
+                continue;
+
+            // Best of three, so a stray context switch does not fail the run
+            double nsPerSample = std::numeric_limits<double>::max();
+            for (int run = 0; run < 3; ++run)
+                nsPerSample = juce::jmin(nsPerSample, runCase<float>(benchCase, goldenChannels, goldenSampleRate, goldenBlockSize, seconds).nsPerSample);
+
+            const auto budgetName = benchCase.mode + " " + benchCase.variant;
+            if (record)
+            {
+                budgets->setProperty(budgetName, nsPerSample);
+                report.add(true, budgetName, juce::String(nsPerSample, 2) + " ns/sample");
+            }
+            else if (const auto budget = storedBudgets.getProperty(budgetName, juce::var()); budget.isVoid())
+            {
+                report.add(false, budgetName, "no budget");
+            }
+            else
+            {
+                const double limit = static_cast<double>(budget) * (1.0 + margin);
+                report.add(nsPerSample <= limit, budgetName, juce::String(nsPerSample, 2) + " ns/sample, limit " + juce::String(limit, 2));
+            }
+        }
+
+        if (record)
+        {
+            juce::DynamicObject::Ptr file = new juce::DynamicObject();
+            file->setProperty("schema", 1);
+            file->setProperty("build", build);
+            file->setProperty("budgets", juce::var(budgets.get()));
+            if (! budgetFile.replaceWithText(juce::JSON::toString(juce::var(file.get()))))
+                report.add(false, budgetFile.getFileName(), "could not write");
+        }
+
+        return report.finish();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i)
+        args.add(argv[i]);
+
+    const bool quick = args.contains("--quick");
+    double seconds = quick ? 0.25 : 1.0;
+    juce::File outputFile;
+
+    if (auto index = args.indexOf("--seconds"); index >= 0 && index + 1 < args.size())
+        seconds = args[index + 1].getDoubleValue();
+    else
+        seconds = args.contains("--record-budgets") || args.contains("--check-budgets") ? 0.25 : seconds;
+
+    // Golden and budget modes replace the timing sweep
+    auto getDirectory = [&args](int index) { return juce::File::getCurrentWorkingDirectory().getChildFile(args[index + 1]); };
+    const int recordIndex = args.indexOf("--record"), verifyIndex = args.indexOf("--verify");
+    if (const int index = juce::jmax(recordIndex, verifyIndex); index >= 0 && index + 1 < args.size())
+    {
+        double tolerance = 0.0; // the recorded one
+        if (auto i = args.indexOf("--tolerance"); i >= 0 && i + 1 < args.size())
+            tolerance = args[i + 1].getDoubleValue();
+
+        return runGolden(getDirectory(index), index == recordIndex, tolerance);
+    }
+
+    const int recordBudgetsIndex = args.indexOf("--record-budgets"), checkBudgetsIndex = args.indexOf("--check-budgets");
+    if (const int index = juce::jmax(recordBudgetsIndex, checkBudgetsIndex); index >= 0 && index + 1 < args.size())
+    {
+        double margin = 0.25;
+        if (auto i = args.indexOf("--margin"); i >= 0 && i + 1 < args.size())
+            margin = args[i + 1].getDoubleValue();
+
+        return runBudgets(getDirectory(index), index == recordBudgetsIndex, margin, seconds);
+    }
+
+    juce::Array<int> channelCounts{ 2 };
+    if (auto index = args.indexOf("--channels"); index >= 0 && index + 1 < args.size())
+    {
+        channelCounts.clear();
+        for (const auto& token : juce::StringArray::fromTokens(args[index + 1], ",", {}))
+            channelCounts.add(juce::jlimit(1, 16, token.getIntValue()));
+    }
+    juce::StringArray precisions{ "float" };
+    if (auto index = args.indexOf("--precision"); index >= 0 && index + 1 < args.size())
+        precisions = juce::StringArray::fromTokens(args[index + 1], ",", {});
+    if (auto index = args.indexOf("--output"); index >= 0 && index + 1 < args.size())
+        outputFile = juce::File::getCurrentWorkingDirectory().getChildFile(args[index + 1]);
+
+    const std::vector<double> sampleRates = quick ? std::vector<double>{ 48000.0 }
+                                                  : std::vector<double>{ 44100.0, 48000.0, 96000.0, 192000.0, 384000.0 };
+    const std::vector<int> blockSizes = quick ? std::vector<int>{ 64, 512 }
+                                              : std::vector<int>{ 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+
+    juce::Array<juce::var> results;
+
+    for (const auto& benchCase : makeCases(quick))
+    {
+        for (const auto& precision : precisions)
+        {
+            for (auto numChannels : channelCounts)
+            {
+                for (auto sampleRate : sampleRates)
+                {
+                    for (auto blockSize : blockSizes)
+                    {
+                        const bool useDouble = precision == "double";
+                        const auto r = useDouble ? runCase<double>(benchCase, numChannels, sampleRate, blockSize, seconds)
+                                                 : runCase<float>(benchCase, numChannels, sampleRate, blockSize, seconds);
+
+                        auto* entry = new juce::DynamicObject();
+                        entry->setProperty("mode", benchCase.mode);
+                        entry->setProperty("variant", benchCase.variant);
+                        entry->setProperty("precision", useDouble ? "double" : "float");
+                        entry->setProperty("channels", numChannels);
+                        entry->setProperty("sampleRate", sampleRate);
+                        entry->setProperty("blockSize", blockSize);
+                        entry->setProperty("nsPerSample", r.nsPerSample);
+                        entry->setProperty("realtimeFactor", r.realtimeFactor);
+                        entry->setProperty("meanBlockNs", r.meanBlockNs);
+                        entry->setProperty("p99BlockNs", r.p99BlockNs);
+                        entry->setProperty("maxBlockNs", r.maxBlockNs);
+                        entry->setProperty("blocks", r.numBlocks);
+                        results.add(juce::var(entry));
+
+                        std::fprintf(stderr, "%-8s %-14s %-6s %2dch %7.0f Hz %5d  %8.2f ns/sample  x%-8.1f p99 %.0f ns\n",
+                                     benchCase.mode.toRawUTF8(), benchCase.variant.toRawUTF8(), useDouble ? "double" : "float",
+                                     numChannels, sampleRate, blockSize,
+                                     r.nsPerSample, r.realtimeFactor, r.p99BlockNs);
+                    }
+                }
+            }
+        }
+    }
+
+    auto* report = new juce::DynamicObject();
+    report->setProperty("schema", 1);
+    report->setProperty("build", describeBuild());
+    report->setProperty("results", results);
+    const auto json = juce::JSON::toString(juce::var(report));
+
+    if (outputFile != juce::File())
+    {
+        if (! outputFile.replaceWithText(json))
+        {
+            std::fprintf(stderr, "Could not write %s\n", outputFile.getFullPathName().toRawUTF8());
+            return 1;
+        }
+    }
+    else
+    {
+        std::printf("%s\n", json.toRawUTF8());
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,159 @@
+// === File: CombEngine.h ===
+#pragma once
+
+#include <JuceHeader.h>
+
+// Comb and flanger engine: the feedback comb y = x + feedback * y(n - d). Its delay memory is
+// interleaved by SIMD lane group (one register per sample position), so all channels of a
+// group read, mix and write the loop with single vector operations. Working sample by sample also lets the loop run at any delay down to one
+// sample. The comb reads every lane at one delay per block (crossfading between two while the
+// caller's DelayTapFade moves it); the flanger's per-channel, per-sample delays gather their
+// lanes from the same positions and share the vector mix and write.
+//
+// As with DelayLine, the write head only moves in advance(), so a mode that is switched off
+// can keep its history in step with the others.
+template <typename SampleType>
+class CombEngine
+{
+public:
+    void prepare(int numChannels, int maxDelaySamples)
+    {
+        numGroups = (numChannels + lanes - 1) / lanes;
+        capacity = juce::nextPowerOfTwo(juce::jmax(1, maxDelaySamples) + 2);
+        mask = capacity - 1;
+        storage.assign(static_cast<size_t>(numGroups * capacity), Vec());
+        reset();
+    }
+
+    void reset()
+    {
+        std::fill(storage.begin(), storage.end(), Vec::expand(SampleType(0)));
+        writeHead = 0;
+    }
+
+    bool isPrepared() const noexcept { return numGroups > 0; }
+    int getMaxDelaySamples() const noexcept { return capacity - 2; }
+
+    void advance(int numSamples) noexcept { writeHead = (writeHead + numSamples) & mask; }
+
+    // One delay for every channel. While fadeGains is set, the delayed signal crossfades from
+    // previousDelay to delay: old + (new - old) * fadeGains[i]. feedbackRamp, if set, replaces
+    // feedback per sample.
+    void processFixed(SampleType* const* channels, int numChannels, float delay, float previousDelay, const SampleType* fadeGains,
+                      const SampleType* feedbackRamp, SampleType feedback, int numSamples) noexcept
+    {
+        const Tap tap = makeTap(delay);
+        const Tap previousTap = makeTap(fadeGains != nullptr ? previousDelay : delay);
+
+        forEachGroup(channels, numChannels, numSamples, [&](Vec* line, int i) noexcept
+            {
+                Vec delayed = read(line, tap, i);
+                if (fadeGains != nullptr)
+                {
+                    const Vec old = read(line, previousTap, i);
+                    delayed = old + (delayed - old) * fadeGains[i];
+                }
+                return delayed * (feedbackRamp != nullptr ? feedbackRamp[i] : feedback);
+            });
+    }
+
+    // Per-channel, per-sample delays: delays[ch][i], in samples
+    void processModulated(SampleType* const* channels, int numChannels, const float* const* delays, const SampleType* feedbackRamp,
+                          SampleType feedback, int numSamples) noexcept
+    {
+        const auto maxDelay = static_cast<float>(getMaxDelaySamples());
+        const float* const* groupDelays = delays;
+        int groupChannels = 0;
+
+        forEachGroup(channels, numChannels, numSamples, [&](Vec* line, int i) noexcept
+            {
+                // Each lane gathers its own pair of positions; the mix stays vectorised
+                alignas(Vec::SIMDRegisterSize) SampleType delayed[lanes] = {};
+                const auto* samples = reinterpret_cast<const SampleType*>(line);
+                for (int c = 0; c < groupChannels; ++c)
+                {
+                    const float d = juce::jlimit(1.0f, maxDelay, groupDelays[c][i]);
+                    const int di = static_cast<int>(d);
+                    const auto fd = static_cast<SampleType>(d - static_cast<float>(di));
+                    const int i0 = (writeHead + i - di - 1) & mask;
+                    const int i1 = (i0 + 1) & mask;
+                    delayed[c] = fd * samples[i0 * lanes + c] + (SampleType(1) - fd) * samples[i1 * lanes + c];
+                }
+                return Vec::fromRawArray(delayed) * (feedbackRamp != nullptr ? feedbackRamp[i] : feedback);
+            },
+            [&](int firstChannel, int channelsInGroup) noexcept
+            {
+                groupDelays = delays + firstChannel;
+                groupChannels = channelsInGroup;
+            });
+    }
+
+private:
+    using Vec = juce::dsp::SIMDRegister<SampleType>;
+    static constexpr int lanes = static_cast<int>(Vec::size());
+
+    // line(n - d) = fraction * line[n - whole - 1] + (1 - fraction) * line[n - whole], as DelayLine reads it
+    struct Tap
+    {
+        int whole;
+        SampleType older, newer;
+    };
+
+    Tap makeTap(float delay) const noexcept
+    {
+        const float d = juce::jlimit(1.0f, static_cast<float>(getMaxDelaySamples()), delay);
+        const int whole = static_cast<int>(d);
+        const auto fraction = static_cast<SampleType>(d - static_cast<float>(whole));
+        return { whole, fraction, SampleType(1) - fraction };
+    }
+
+    Vec read(const Vec* line, const Tap& tap, int i) const noexcept
+    {
+        const int i0 = (writeHead + i - tap.whole - 1) & mask;
+        return line[i0] * tap.older + line[(i0 + 1) & mask] * tap.newer;
+    }
+
+    // Runs y = x + feedbackTerm(line, i) over every group, writing y to the line and the output
+    template <typename FeedbackFn>
+    void forEachGroup(SampleType* const* channels, int numChannels, int numSamples, FeedbackFn&& feedbackTerm) noexcept
+    {
+        forEachGroup(channels, numChannels, numSamples, std::forward<FeedbackFn>(feedbackTerm), [](int, int) noexcept {});
+    }
+
+    template <typename FeedbackFn, typename GroupFn>
+    void forEachGroup(SampleType* const* channels, int numChannels, int numSamples, FeedbackFn&& feedbackTerm, GroupFn&& startGroup) noexcept
+    {
+        alignas(Vec::SIMDRegisterSize) SampleType io[lanes] = {};
+
+        for (int group = 0; group < numGroups; ++group)
+        {
+            const int firstChannel = group * lanes;
+            const int groupChannels = juce::jmin(lanes, numChannels - firstChannel);
+            if (groupChannels <= 0)
+                break;
+
+            startGroup(firstChannel, groupChannels);
+            SampleType* const* ch = channels + firstChannel;
+            Vec* line = storage.data() + group * capacity;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                for (int c = 0; c < lanes; ++c)
+                    io[c] = c < groupChannels ? ch[c][i] : SampleType(0);
+
+                const Vec y = Vec::fromRawArray(io) + feedbackTerm(line, i);
+                line[(writeHead + i) & mask] = y;
+
+                y.copyToRawArray(io);
+                for (int c = 0; c < groupChannels; ++c)
+                    ch[c][i] = io[c];
+            }
+        }
+    }
+
+    int numGroups{ 0 };
+    int capacity{ 1 };
+    int mask{ 0 };
+    int writeHead{ 0 };
+    std::vector<Vec> storage; // per group: capacity registers, one lane per channel
+};
\ No newline at end of file
@@ -0,0 +1,167 @@
+// === File: CpuMeter.cpp ===
+#include "CpuMeter.h"
+#include <cmath>
+
+#if DFP_CPU_METER && JUCE_INTEL
+ #if JUCE_MSVC
+  #include <intrin.h>
+ #else
+  #include <x86intrin.h>
+ #endif
+#endif
+
+const char* CpuMeter::getCategoryName(int category) noexcept
+{
+    static const char* const names[numCategories] = { "Comb", "FIR", "IIR", "Phaser", "Flanger", "Chain", "Idle" };
+    return names[juce::jlimit(0, numCategories - 1, category)];
+}
+
+double CpuMeter::getBinUpperLoad(int bin) noexcept
+{
+    return bin >= overBudgetBin ? HUGE_VAL : std::exp2(static_cast<double>(bin - (overBudgetBin - 1)));
+}
+
+#if DFP_CPU_METER
+
+namespace
+{
+    // Reference (constant-rate) cycles where there is a time stamp counter, else none
+    inline juce::uint64 readCycles() noexcept
+    {
+       #if JUCE_INTEL
+        return static_cast<juce::uint64>(__rdtsc());
+       #else
+        return 0;
+       #endif
+    }
+}
+
+void CpuMeter::prepare(double newSampleRate, int newBlockSize)
+{
+    // A second of blocks between drains, four times over for hosts that split the block
+    // they announced
+    const auto blocksPerSecond = newSampleRate / juce::jmax(1, newBlockSize);
+    const int fifoSize = juce::nextPowerOfTwo(juce::jlimit(64, 1 << 16, static_cast<int>(std::ceil(4.0 * blocksPerSecond)) + 1));
+    if (static_cast<int>(records.size()) != fifoSize)
+    {
+        records.assign(static_cast<size_t>(fifoSize), {});
+        fifo.setTotalSize(fifoSize);
+    }
+    fifo.reset();
+
+    sampleRate.store(newSampleRate, std::memory_order_relaxed);
+    blockSize.store(newBlockSize, std::memory_order_relaxed);
+    budgetNsPerSample = 1.0e9 / newSampleRate;
+}
+
+CpuMeter::ScopedBlock::ScopedBlock(CpuMeter& meterToUse, int numSamples) noexcept
+    : meter(meterToUse), startTicks(juce::Time::getHighResolutionTicks()), startCycles(readCycles())
+{
+    record.numSamples = numSamples;
+}
+
+CpuMeter::ScopedBlock::~ScopedBlock() noexcept
+{
+    const auto cycles = readCycles() - startCycles;
+    const auto ticks = juce::Time::getHighResolutionTicks() - startTicks;
+    record.ns = static_cast<float>(static_cast<double>(ticks) * meter.nsPerTick);
+    record.cycles = static_cast<float>(cycles);
+    record.budgetNs = static_cast<float>(record.numSamples * meter.budgetNsPerSample);
+
+    // Wait-free: a full FIFO (no message thread draining it) just drops the record
+    const auto scope = meter.fifo.write(1);
+    if (scope.blockSize1 > 0)
+        meter.records[static_cast<size_t>(scope.startIndex1)] = record;
+    else
+        meter.droppedRecords.fetch_add(1, std::memory_order_relaxed);
+}
+
+void CpuMeter::collect() noexcept
+{
+    double windowNs = 0.0, windowBudgetNs = 0.0, windowPeak = 0.0;
+
+    const auto scope = fifo.read(fifo.getNumReady());
+    auto fold = [&](int start, int count)
+        {
+            for (int i = start; i < start + count; ++i)
+            {
+                const auto& r = records[static_cast<size_t>(i)];
+                auto& category = stats.categories[juce::jlimit(0, numCategories - 1, r.category)];
+                const double load = r.budgetNs > 0.0f ? r.ns / r.budgetNs : 0.0;
+
+                ++category.blocks;
+                category.samples += r.numSamples;
+                category.totalNs += r.ns;
+                category.totalCycles += r.cycles;
+                category.maxNs = juce::jmax(category.maxNs, static_cast<double>(r.ns));
+                if (load > 1.0)
+                    ++category.overBudget;
+
+                const int bin = load > 0.0 ? juce::jlimit(0, overBudgetBin, static_cast<int>(std::ceil(std::log2(load))) + overBudgetBin - 1) : 0;
+                ++stats.histogram[bin];
+
+                windowNs += r.ns;
+                windowBudgetNs += r.budgetNs;
+                windowPeak = juce::jmax(windowPeak, load);
+            }
+        };
+    fold(scope.startIndex1, scope.blockSize1);
+    fold(scope.startIndex2, scope.blockSize2);
+
+    if (windowBudgetNs > 0.0)
+    {
+        stats.recentLoad = windowNs / windowBudgetNs;
+        stats.recentPeakLoad = windowPeak;
+    }
+
+    stats.droppedRecords += droppedRecords.exchange(0, std::memory_order_relaxed);
+    stats.sampleRate = sampleRate.load(std::memory_order_relaxed);
+    stats.blockSize = blockSize.load(std::memory_order_relaxed);
+}
+
+void CpuMeter::resetStats() noexcept
+{
+    collect(); // discard whatever is queued along with the totals
+    stats = Stats();
+}
+
+bool CpuMeter::dumpToFile(const juce::File& file) const
+{
+    juce::Array<juce::var> categories;
+    for (int c = 0; c < numCategories; ++c)
+    {
+        const auto& s = stats.categories[c];
+        auto* entry = new juce::DynamicObject();
+        entry->setProperty("mode", getCategoryName(c));
+        entry->setProperty("blocks", s.blocks);
+        entry->setProperty("samples", s.samples);
+        entry->setProperty("overBudget", s.overBudget);
+        entry->setProperty("meanBlockNs", s.blocks > 0 ? s.totalNs / static_cast<double>(s.blocks) : 0.0);
+        entry->setProperty("maxBlockNs", s.maxNs);
+        entry->setProperty("nsPerSample", s.samples > 0 ? s.totalNs / static_cast<double>(s.samples) : 0.0);
+        entry->setProperty("cyclesPerSample", s.samples > 0 ? s.totalCycles / static_cast<double>(s.samples) : 0.0);
+        categories.add(juce::var(entry));
+    }
+
+    juce::Array<juce::var> histogram;
+    for (int bin = 0; bin < numBins; ++bin)
+    {
+        auto* entry = new juce::DynamicObject();
+        entry->setProperty("maxLoad", bin < overBudgetBin ? juce::var(getBinUpperLoad(bin)) : juce::var("over"));
+        entry->setProperty("blocks", stats.histogram[bin]);
+        histogram.add(juce::var(entry));
+    }
+
+    auto* report = new juce::DynamicObject();
+    report->setProperty("schema", 1);
+    report->setProperty("timestamp", juce::Time::getCurrentTime().toISO8601(true));
+    report->setProperty("cpu", juce::SystemStats::getCpuModel());
+    report->setProperty("sampleRate", stats.sampleRate);
+    report->setProperty("blockSize", stats.blockSize);
+    report->setProperty("droppedRecords", stats.droppedRecords);
+    report->setProperty("modes", categories);
+    report->setProperty("loadHistogram", histogram);
+    return file.replaceWithText(juce::JSON::toString(juce::var(report)));
+}
+
+#endif
\ No newline at end of file
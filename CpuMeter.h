@@ -0,0 +1,108 @@
+// === File: CpuMeter.h ===
+#pragma once
+
+#include <JuceHeader.h>
+
+// Per-instance processBlock timing. The audio thread stamps each block (nanoseconds, TSC cycles
+// where the CPU has one, the block's real-time budget and the filter mode) and pushes one record
+// into a single-producer AbstractFifo; the message thread drains it into running statistics that
+// the editor shows and dumpToFile() writes out as JSON.
+// On by default; define DFP_CPU_METER=0 to strip it (the class then compiles to no-ops).
+#ifndef DFP_CPU_METER
+ #define DFP_CPU_METER 1
+#endif
+
+class CpuMeter
+{
+public:
+    // Filter modes in "filterType" order, chain routing, and blocks that took the silence bypass
+    static constexpr int numCategories = 7;
+    static constexpr int chainCategory = 5;
+    static constexpr int idleCategory = 6;
+    static const char* getCategoryName(int category) noexcept;
+
+    // Load histogram: bin 0 is up to 1/1024 of the budget, each bin after doubles the bound up
+    // to bin overBudgetBin - 1 (the whole budget); the last bin counts over-budget blocks
+    static constexpr int numBins = 12;
+    static constexpr int overBudgetBin = numBins - 1;
+    static double getBinUpperLoad(int bin) noexcept;
+
+    struct CategoryStats
+    {
+        juce::int64 blocks{ 0 }, samples{ 0 }, overBudget{ 0 };
+        double totalNs{ 0.0 }, maxNs{ 0.0 }, totalCycles{ 0.0 };
+    };
+
+    struct Stats
+    {
+        CategoryStats categories[numCategories];
+        juce::int64 histogram[numBins]{};
+        juce::int64 droppedRecords{ 0 };
+        double recentLoad{ 0.0 }, recentPeakLoad{ 0.0 }; // fraction of the budget, last drain
+        double sampleRate{ 0.0 };
+        int blockSize{ 0 };
+    };
+
+#if DFP_CPU_METER
+    static constexpr bool enabled = true;
+
+    // Sizes the record queue for the block rate; call while the audio thread is stopped
+    void prepare(double sampleRate, int blockSize);
+
+    // Audio thread: time one processBlock call
+    class ScopedBlock
+    {
+    public:
+        ScopedBlock(CpuMeter& meterToUse, int numSamples) noexcept;
+        ~ScopedBlock() noexcept;
+        void setCategory(int category) noexcept { record.category = category; }
+
+    private:
+        CpuMeter& meter;
+        juce::int64 startTicks;
+        juce::uint64 startCycles;
+
+        struct Record
+        {
+            float ns{ 0.0f }, budgetNs{ 0.0f }, cycles{ 0.0f };
+            int numSamples{ 0 }, category{ 0 };
+        } record;
+
+        friend class CpuMeter;
+    };
+
+    // Message thread: fold the queued records into the stats
+    void collect() noexcept;
+    const Stats& getStats() const noexcept { return stats; }
+    void resetStats() noexcept;
+    bool dumpToFile(const juce::File& file) const;
+
+private:
+    juce::AbstractFifo fifo{ 1 }; // holds nothing until prepare()
+    std::vector<ScopedBlock::Record> records;
+    std::atomic<int> droppedRecords{ 0 };
+    std::atomic<double> sampleRate{ 44100.0 };
+    std::atomic<int> blockSize{ 0 };
+    double budgetNsPerSample{ 1.0e9 / 44100.0 };
+    const double nsPerTick{ 1.0e9 / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond()) };
+    Stats stats;
+#else
+    static constexpr bool enabled = false;
+
+    void prepare(double, int) noexcept {}
+
+    struct ScopedBlock
+    {
+        ScopedBlock(CpuMeter&, int) noexcept {}
+        void setCategory(int) noexcept {}
+    };
+
+    void collect() noexcept {}
+    const Stats& getStats() const noexcept { return stats; }
+    void resetStats() noexcept {}
+    bool dumpToFile(const juce::File&) const { return false; }
+
+private:
+    Stats stats;
+#endif
+};
\ No newline at end of file
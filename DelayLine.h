@@ -0,0 +1,414 @@
+// === File: DelayLine.h ===
+#pragma once
+
+#include <JuceHeader.h>
+
+// Multi-channel circular delay line with a power-of-two capacity (wrapping is a mask) and a
+// mirrored guard region after the end: the first guardSize samples are duplicated past the
+// capacity, so an interpolated read of up to guardSize - 1 consecutive samples never wraps.
+//
+// All block calls are relative to the write head, which stays put until advance() is called:
+// offset k refers to the sample that will be written at writeHead + k. Delays are in samples
+// and must be >= 1 for reads that overlap samples written in the same call sequence.
+// Storage is in the processing precision, or compact (below); delay times are always float.
+//
+// Compact storage is 16-bit block floating point: each compactBlockSize run of samples shares
+// a power-of-two scale, chosen when the run is started and raised (rescaling the samples
+// already written) if a later write in the same run is louder. About 90 dB below the block
+// peak, at half the memory and bandwidth of float, for long delays where that is enough.
+enum class DelayStorage { full = 0, compact };
+
+template <typename SampleType>
+class DelayLine
+{
+public:
+    void prepare(int numChannels, int maxDelaySamples, int maxBlockSize, DelayStorage newStorage = DelayStorage::full)
+    {
+        storageType = newStorage;
+        guardSize = juce::jmax(1, maxBlockSize) + 1;
+
+        // Compact: mirror whole blocks, and keep one spare block so the run a write starts is
+        // never one a reader can still reach
+        const bool compact = storageType == DelayStorage::compact;
+        if (compact)
+            guardSize = (guardSize + compactBlockSize - 1) & ~(compactBlockSize - 1);
+        reserve = compact ? compactBlockSize : 0;
+
+        capacity = juce::nextPowerOfTwo(juce::jmax(1, maxDelaySamples) + guardSize + reserve);
+        mask = capacity - 1;
+        numLineChannels = numChannels;
+        stride = capacity + guardSize;
+
+        if (compact)
+        {
+            getScaleTables(); // build the shared tables off the audio thread
+            storage.setSize(0, 0);
+            compactSamples.assign(static_cast<size_t>(numChannels * stride), 0);
+            compactExponents.assign(static_cast<size_t>(numChannels * (stride >> compactBlockShift)), minExponent);
+        }
+        else
+        {
+            storage.setSize(numChannels, stride);
+            compactSamples = {};
+            compactExponents = {};
+        }
+        clear();
+    }
+
+    void clear()
+    {
+        storage.clear();
+        std::fill(compactSamples.begin(), compactSamples.end(), juce::int16(0));
+        std::fill(compactExponents.begin(), compactExponents.end(), minExponent);
+        writeHead = 0;
+    }
+
+    int getNumChannels() const noexcept { return numLineChannels; }
+    int getCapacity() const noexcept { return capacity; }
+    DelayStorage getStorage() const noexcept { return storageType; }
+
+    // Longest block a single read/write call may cover
+    int getMaxBlockSize() const noexcept { return guardSize - 1; }
+
+    // Longest delay a read of up to getMaxBlockSize() samples may use
+    int getMaxDelaySamples() const noexcept { return capacity - guardSize - reserve; }
+
+    void advance(int numSamples) noexcept { writeHead = (writeHead + numSamples) & mask; }
+
+    // Writes numSamples starting at writeHead + offset, keeping the mirror in sync.
+    void write(int channel, int offset, const SampleType* src, int numSamples) noexcept
+    {
+        const int pos = (writeHead + offset) & mask;
+        const int first = juce::jmin(numSamples, capacity - pos);
+        const bool wraps = first < numSamples;
+
+        if (storageType == DelayStorage::compact)
+        {
+            writeCompact(channel, pos, src, first);
+            if (wraps)
+                writeCompact(channel, 0, src + first, numSamples - first);
+        }
+        else
+        {
+            SampleType* data = storage.getWritePointer(channel);
+            juce::FloatVectorOperations::copy(data + pos, src, first);
+            if (wraps)
+                juce::FloatVectorOperations::copy(data, src + first, numSamples - first);
+        }
+
+        // Only the part of this write that landed in the guard's source region is mirrored, so
+        // short writes near the start of the buffer stay short
+        updateMirror(channel, pos, first);
+        if (wraps)
+            updateMirror(channel, 0, numSamples - first);
+    }
+
+    // dest[k] = line(writeHead + offset + k - delaySamples), linearly interpolated
+    void read(int channel, int offset, float delaySamples, SampleType* dest, int numSamples) const noexcept
+    {
+        jassert(numSamples < guardSize);
+        const int start = getTapStart(offset, delaySamples);
+        const auto fd = static_cast<SampleType>(delaySamples - std::floor(delaySamples));
+        const SampleType g0 = fd, g1 = SampleType(1) - fd;
+
+        if (storageType == DelayStorage::compact)
+        {
+            const CompactReader at{ *this, channel };
+            for (int k = 0; k < numSamples; ++k)
+                dest[k] = g0 * at[start + k] + g1 * at[start + k + 1];
+            return;
+        }
+
+        const SampleType* src = storage.getReadPointer(channel) + start;
+        for (int k = 0; k < numSamples; ++k)
+            dest[k] = g0 * src[k] + g1 * src[k + 1];
+    }
+
+    // dest[k] += gain * line(writeHead + offset + k - delaySamples)
+    void addFrom(int channel, int offset, float delaySamples, float gain, SampleType* dest, int numSamples) const noexcept
+    {
+        jassert(numSamples < guardSize);
+        const int start = getTapStart(offset, delaySamples);
+        const auto fd = static_cast<SampleType>(delaySamples - std::floor(delaySamples));
+        const SampleType g0 = gain * fd, g1 = gain * (SampleType(1) - fd);
+
+        if (storageType == DelayStorage::compact)
+        {
+            const CompactReader at{ *this, channel };
+            for (int k = 0; k < numSamples; ++k)
+                dest[k] += g0 * at[start + k] + g1 * at[start + k + 1];
+            return;
+        }
+
+        const SampleType* src = storage.getReadPointer(channel) + start;
+        for (int k = 0; k < numSamples; ++k)
+            dest[k] += g0 * src[k] + g1 * src[k + 1];
+    }
+
+    // Per-sample delays (e.g. LFO-swept): dest[k] = line(writeHead + offset + k - delaySamples[k])
+    void readModulated(int channel, int offset, const float* delaySamples, SampleType* dest, int numSamples) const noexcept
+    {
+        if (storageType == DelayStorage::compact)
+            readModulatedFrom(CompactReader{ *this, channel }, offset, delaySamples, dest, numSamples);
+        else
+            readModulatedFrom(storage.getReadPointer(channel), offset, delaySamples, dest, numSamples);
+    }
+
+    // Carries numSamples of another line's history (e.g. the line this replaces) over, oldest
+    // first from delaySamples back, lined up with this write head. Copying the whole history in
+    // slices lets it move across several blocks. scratch needs room for one chunk of up to
+    // getMaxBlockSize().
+    void copyHistoryFrom(const DelayLine& other, int delaySamples, int numSamples, SampleType* scratch, int scratchSize) noexcept
+    {
+        delaySamples = juce::jmin(delaySamples, other.getMaxDelaySamples(), getMaxDelaySamples());
+        numSamples = juce::jmin(numSamples, delaySamples);
+        const int chunk = juce::jmin(scratchSize, other.getMaxBlockSize(), getMaxBlockSize());
+        const int channels = juce::jmin(numLineChannels, other.getNumChannels());
+
+        for (int ch = 0; ch < channels; ++ch)
+        {
+            for (int done = 0; done < numSamples; done += chunk)
+            {
+                const int len = juce::jmin(chunk, numSamples - done);
+                const int delay = delaySamples - done;
+                other.read(ch, 0, static_cast<float>(delay), scratch, len);
+                write(ch, -delay, scratch, len);
+            }
+        }
+    }
+
+private:
+    static constexpr int compactBlockShift = 4;
+    static constexpr int compactBlockSize = 1 << compactBlockShift;
+    static constexpr juce::int8 minExponent = -40, maxExponent = 40;
+    static constexpr int numExponents = maxExponent - minExponent + 1;
+    static constexpr SampleType fullScale = SampleType(32767);
+
+    // Per exponent e: the 16-bit step (2^e / 32767) and its inverse
+    struct ScaleTables
+    {
+        SampleType toSample[numExponents], toInteger[numExponents];
+    };
+
+    static const ScaleTables& getScaleTables()
+    {
+        static const ScaleTables tables = []
+        {
+            ScaleTables t{};
+            for (int i = 0; i < numExponents; ++i)
+            {
+                t.toSample[i] = static_cast<SampleType>(std::ldexp(1.0, i + minExponent)) / fullScale;
+                t.toInteger[i] = fullScale / static_cast<SampleType>(std::ldexp(1.0, i + minExponent));
+            }
+            return t;
+        }();
+        return tables;
+    }
+
+    struct CompactReader
+    {
+        CompactReader(const DelayLine& line, int channel) noexcept
+            : samples(line.compactSamples.data() + channel * line.stride),
+              exponents(line.compactExponents.data() + channel * (line.stride >> compactBlockShift)),
+              toSample(getScaleTables().toSample)
+        {
+        }
+
+        SampleType operator[](int index) const noexcept
+        {
+            return static_cast<SampleType>(samples[index]) * toSample[exponents[index >> compactBlockShift] - minExponent];
+        }
+
+        const juce::int16* samples;
+        const juce::int8* exponents;
+        const SampleType* toSample;
+    };
+
+    // Index of the older of the two interpolation points for the first sample of a block.
+    // line(w - d) with d = di + fd lies between data[w - di - 1] (weight fd) and data[w - di].
+    int getTapStart(int offset, float delaySamples) const noexcept
+    {
+        const int di = static_cast<int>(delaySamples);
+        return (writeHead + offset - di - 1) & mask;
+    }
+
+    template <typename Source>
+    void readModulatedFrom(const Source& data, int offset, const float* delaySamples, SampleType* dest, int numSamples) const noexcept
+    {
+        const int base = writeHead + offset - 1;
+
+        for (int k = 0; k < numSamples; ++k)
+        {
+            const float d = delaySamples[k];
+            const int di = static_cast<int>(d);
+            const auto fd = static_cast<SampleType>(d - static_cast<float>(di));
+            const int i0 = (base + k - di) & mask;
+            dest[k] = fd * data[i0] + (SampleType(1) - fd) * data[i0 + 1];
+        }
+    }
+
+    // Copies [start, start + length) to the mirror past the capacity, clipped to the first
+    // guardSize samples. Compact storage mirrors whole blocks, since a write can rescale the
+    // samples already in its block.
+    void updateMirror(int channel, int start, int length) noexcept
+    {
+        if (start >= guardSize || length <= 0)
+            return;
+
+        if (storageType == DelayStorage::compact)
+        {
+            const int first = start & ~(compactBlockSize - 1);
+            const int end = juce::jmin(guardSize, (start + length + compactBlockSize - 1) & ~(compactBlockSize - 1));
+            juce::int16* data = getCompactSamples(channel);
+            juce::int8* exponents = getCompactExponents(channel);
+            std::copy(data + first, data + end, data + capacity + first);
+            std::copy(exponents + (first >> compactBlockShift), exponents + (end >> compactBlockShift),
+                      exponents + ((capacity + first) >> compactBlockShift));
+            return;
+        }
+
+        SampleType* data = storage.getWritePointer(channel);
+        juce::FloatVectorOperations::copy(data + capacity + start, data + start, juce::jmin(length, guardSize - start));
+    }
+
+    juce::int16* getCompactSamples(int channel) noexcept { return compactSamples.data() + channel * stride; }
+    juce::int8* getCompactExponents(int channel) noexcept { return compactExponents.data() + channel * (stride >> compactBlockShift); }
+
+    // Smallest exponent e with peak <= 2^e
+    static juce::int8 getExponent(SampleType peak) noexcept
+    {
+        int e = minExponent;
+        if (peak > SampleType(0))
+            std::frexp(peak, &e);
+        return static_cast<juce::int8>(juce::jlimit<int>(minExponent, maxExponent, e));
+    }
+
+    // Non-wrapping run of samples starting at pos
+    void writeCompact(int channel, int pos, const SampleType* src, int numSamples) noexcept
+    {
+        juce::int16* data = getCompactSamples(channel);
+        juce::int8* exponents = getCompactExponents(channel);
+        const auto& tables = getScaleTables();
+
+        while (numSamples > 0)
+        {
+            const int block = pos >> compactBlockShift;
+            const int inBlock = pos & (compactBlockSize - 1);
+            const int len = juce::jmin(numSamples, compactBlockSize - inBlock);
+
+            SampleType peak = 0;
+            for (int k = 0; k < len; ++k)
+                peak = juce::jmax(peak, std::abs(src[k]));
+
+            // A run being continued keeps its samples: raise its scale if this write is louder
+            juce::int8 exponent = getExponent(peak);
+            if (inBlock > 0)
+            {
+                const int shift = exponent - exponents[block];
+                if (shift <= 0)
+                    exponent = exponents[block];
+                else
+                    for (int i = pos - inBlock; i < pos; ++i)
+                        data[i] = static_cast<juce::int16>(data[i] / (1 << juce::jmin(shift, 15)));
+            }
+            exponents[block] = exponent;
+
+            const SampleType toInteger = tables.toInteger[exponent - minExponent];
+            for (int k = 0; k < len; ++k)
+            {
+                const SampleType scaled = src[k] * toInteger;
+                data[pos + k] = static_cast<juce::int16>(scaled + (scaled >= SampleType(0) ? SampleType(0.5) : SampleType(-0.5)));
+            }
+
+            pos += len;
+            src += len;
+            numSamples -= len;
+        }
+    }
+
+    // Full storage
+    juce::AudioBuffer<SampleType> storage;
+
+    // Compact storage: 16-bit samples and one exponent per block, both with the mirrored guard
+    std::vector<juce::int16> compactSamples;
+    std::vector<juce::int8> compactExponents;
+
+    DelayStorage storageType{ DelayStorage::full };
+    int numLineChannels{ 0 };
+    int stride{ 0 };
+    int capacity{ 1 };
+    int mask{ 0 };
+    int guardSize{ 1 };
+    int reserve{ 0 };
+    int writeHead{ 0 };
+};
+
+// Block-rate delay time of one read tap. Any move, however small, crossfades from a read at the
+// old delay to a read at the new one over fadeSeconds (spanning blocks if need be), which
+// neither clicks nor warbles the pitch like a per-sample sweep of the read position would, and
+// doesn't zipper like snapping small steps would. A move that arrives mid-fade waits for it to
+// finish, so a sweep becomes a chain of fades. Only an unchanged delay settles into one read at
+// getDelay(), the block fast path.
+class DelayTapFade
+{
+public:
+    static constexpr double fadeSeconds = 0.005;
+
+    void prepare(double sampleRate) noexcept
+    {
+        fadeLength = juce::jmax(1, static_cast<int>(sampleRate * fadeSeconds));
+        reset();
+    }
+
+    // The next delay snaps
+    void reset() noexcept
+    {
+        from = to = -1.0f;
+        position = fadeLength;
+    }
+
+    // Once per block, before reading; the first delay after reset() snaps
+    void setDelay(float delaySamples) noexcept
+    {
+        if (to < 0.0f)
+            to = delaySamples;
+        else if (delaySamples != to)
+            jumpTo(delaySamples);
+    }
+
+    // Crossfades to delaySamples, even to the same delay (e.g. a tap table that changed shape)
+    void jumpTo(float delaySamples) noexcept
+    {
+        if (isFading())
+            return;
+        if (to >= 0.0f)
+        {
+            from = to;
+            position = 0;
+        }
+        to = delaySamples;
+    }
+
+    bool isFading() const noexcept { return position < fadeLength; }
+    float getDelay() const noexcept { return to; }
+    float getPreviousDelay() const noexcept { return from; }
+
+    // Weight of the read at getDelay() for each of the next numSamples; the rest comes from
+    // the read at getPreviousDelay()
+    template <typename SampleType>
+    void getGains(SampleType* dest, int numSamples) const noexcept
+    {
+        const int len = juce::jmin(numSamples, fadeLength - position);
+        const SampleType step = SampleType(1) / static_cast<SampleType>(fadeLength);
+        for (int k = 0; k < len; ++k)
+            dest[k] = static_cast<SampleType>(position + k + 1) * step;
+        std::fill(dest + len, dest + numSamples, SampleType(1));
+    }
+
+    void advance(int numSamples) noexcept { position = juce::jmin(fadeLength, position + numSamples); }
+
+private:
+    float from{ -1.0f }, to{ -1.0f };
+    int fadeLength{ 1 };
+    int position{ 1 };
+};
\ No newline at end of file
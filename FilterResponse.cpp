@@ -0,0 +1,126 @@
+// === File: FilterResponse.cpp ===
+#include "FilterResponse.h"
+#include "FirEngine.h"
+#include "PhaserEngine.h"
+#include "StateVariableFilter.h"
+
+namespace
+{
+    using Complex = std::complex<double>;
+
+    // Feedback comb as the kernel runs it: y[n] = x[n] + feedback * y[n - D]
+    Complex getCombResponse(double omega, double delaySamples, double feedback) noexcept
+    {
+        return 1.0 / (1.0 - feedback * std::polar(1.0, -omega * delaySamples));
+    }
+}
+
+bool FilterResponse::Settings::operator==(const Settings& other) const noexcept
+{
+    return std::equal(modes, modes + maxModes, other.modes) && numModes == other.numModes
+        && sampleRate == other.sampleRate && oversamplingFactor == other.oversamplingFactor
+        && mix == other.mix && feedback == other.feedback && filterFreq == other.filterFreq
+        && taps == other.taps && tapGain == other.tapGain && tapSpacingSamples == other.tapSpacingSamples
+        && iirType == other.iirType && iirStages == other.iirStages && iirQ == other.iirQ
+        && phaserStages == other.phaserStages && phaserSpread == other.phaserSpread && phaserFeedback == other.phaserFeedback
+        && lfoDepthMs == other.lfoDepthMs && lfoValue == other.lfoValue;
+}
+
+double FilterResponse::getFrequency(int point) const noexcept
+{
+    return minHz * std::pow(maxHz / minHz, static_cast<double>(point) / (numPoints - 1));
+}
+
+bool FilterResponse::update(const Settings& newSettings)
+{
+    // Only the modulated modes follow the LFO; elsewhere its motion must not cost a recompute
+    Settings relevant = newSettings;
+    if (! usesLfo(relevant))
+        relevant.lfoValue = 0.0f;
+
+    if (valid && relevant == settings)
+        return false;
+
+    settings = relevant;
+    valid = true;
+
+    const double mix = settings.mix;
+    for (int point = 0; point < numPoints; ++point)
+    {
+        const double freqHz = getFrequency(point);
+        Complex wet(1.0, 0.0);
+        for (int i = 0; i < juce::jmin(settings.numModes, maxModes); ++i)
+            wet *= getWetResponse(settings.modes[i], freqHz);
+
+        const Complex h = (1.0 - mix) + mix * wet;
+        magnitudeDb[static_cast<size_t>(point)] = static_cast<float>(20.0 * std::log10(juce::jmax(1.0e-6, std::abs(h))));
+        phase[static_cast<size_t>(point)] = static_cast<float>(std::arg(h));
+    }
+    return true;
+}
+
+bool FilterResponse::usesLfo(const Settings& s) noexcept
+{
+    for (int i = 0; i < juce::jmin(s.numModes, maxModes); ++i)
+        if (s.modes[i] == 3 || s.modes[i] == 4)
+            return true;
+    return false;
+}
+
+Complex FilterResponse::getWetResponse(int mode, double freqHz) const noexcept
+{
+    const double sampleRate = settings.sampleRate;
+    const double omega = juce::MathConstants<double>::twoPi * freqHz / sampleRate;
+    const double samplesPerMs = 0.001 * sampleRate;
+
+    switch (mode)
+    {
+    case 0: // Comb: one filterFreq period
+        return getCombResponse(omega, sampleRate / settings.filterFreq, settings.feedback);
+
+    case 1: // FIR: taps at multiples of the spacing, so each tap's phasor is the last one rotated
+    {
+        const Complex rotation = std::polar(1.0, -omega * settings.tapSpacingSamples);
+        Complex phasor = rotation, h(0.0, 0.0);
+        for (int t = 1; t < settings.taps - 1; ++t)
+        {
+            h += static_cast<double>(FirEngine::getTapGain(t, settings.taps, settings.tapGain)) * phasor;
+            phasor *= rotation;
+        }
+        return h;
+    }
+
+    case 2:
+        return StateVariableFilter<double>::getResponse(static_cast<SvfType>(juce::jlimit(0, 2, settings.iirType)), settings.filterFreq,
+                                                        settings.iirQ, settings.iirStages, freqHz, sampleRate);
+
+    case 3: // Phaser at the kernel's rate, LFO frozen at its current value
+    {
+        const double kernelRate = sampleRate * settings.oversamplingFactor;
+        const Complex zInv = std::polar(1.0, -juce::MathConstants<double>::twoPi * freqHz / kernelRate);
+        const float modScale = 1.0f / (20.0f * static_cast<float>(settings.oversamplingFactor));
+
+        Complex allpass(1.0, 0.0);
+        for (int stage = 0; stage < settings.phaserStages; ++stage)
+        {
+            const float base = PhaserEngine<float>::getBaseCoefficient(stage, settings.phaserStages, settings.filterFreq, settings.phaserSpread, kernelRate);
+            const double a = juce::jlimit(-PhaserEngine<float>::maxCoefficient, PhaserEngine<float>::maxCoefficient,
+                                          base + settings.lfoValue * settings.lfoDepthMs * modScale);
+            allpass *= (a + zInv) / (1.0 + a * zInv);
+        }
+
+        // The last stage's previous output is fed back into the first
+        const Complex looped = allpass / (1.0 - static_cast<double>(settings.phaserFeedback) * zInv * allpass);
+        return 1.0 + (looped - 1.0) * static_cast<double>(settings.feedback);
+    }
+
+    case 4: // Flanger: the comb at its current LFO-displaced delay
+    {
+        const double delayMs = juce::jlimit(0.1, 1000.0, 1000.0 / settings.filterFreq + settings.lfoDepthMs * settings.lfoValue);
+        return getCombResponse(omega, delayMs * samplesPerMs, settings.feedback);
+    }
+
+    default:
+        return 1.0;
+    }
+}
\ No newline at end of file
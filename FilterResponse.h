@@ -0,0 +1,52 @@
+// === File: FilterResponse.h ===
+#pragma once
+
+#include <JuceHeader.h>
+#include <complex>
+
+// Analytic magnitude/phase response of the current mode (a chain is the product of its stages'
+// responses), including the dry/wet mix, on a log-spaced grid from minHz to maxHz. Runs on the
+// message thread from a parameter snapshot (the processor fills one in getResponseSettings());
+// update() only recomputes when the snapshot differs from the last one, so a static setting
+// costs nothing per repaint.
+class FilterResponse
+{
+public:
+    static constexpr int numPoints = 256;
+    static constexpr double minHz = 20.0, maxHz = 20000.0;
+    static constexpr int maxModes = 4;
+
+    struct Settings
+    {
+        int modes[maxModes]{}; // "filterType" indices, in processing order
+        int numModes{ 1 };
+        double sampleRate{ 44100.0 };
+        int oversamplingFactor{ 1 };
+        float mix{ 0.5f }, feedback{ 0.0f }, filterFreq{ 1000.0f };
+        int taps{ 2 }; // after the span limit
+        float tapGain{ 0.5f }, tapSpacingSamples{ 44.1f };
+        int iirType{ 0 }, iirStages{ 1 };
+        float iirQ{ 0.707f };
+        int phaserStages{ 2 };
+        float phaserSpread{ 0.0f }, phaserFeedback{ 0.0f };
+        float lfoDepthMs{ 0.0f }, lfoValue{ 0.0f }; // LFO output of the first channel, [-1, 1]
+
+        bool operator==(const Settings& other) const noexcept;
+        bool operator!=(const Settings& other) const noexcept { return ! (*this == other); }
+    };
+
+    // Returns true if the curves were recomputed
+    bool update(const Settings& newSettings);
+
+    double getFrequency(int point) const noexcept;
+    const float* getMagnitudeDb() const noexcept { return magnitudeDb.data(); }
+    const float* getPhase() const noexcept { return phase.data(); } // radians, wrapped to [-pi, pi]
+
+private:
+    std::complex<double> getWetResponse(int mode, double freqHz) const noexcept;
+    static bool usesLfo(const Settings& s) noexcept;
+
+    Settings settings;
+    bool valid{ false };
+    std::array<float, numPoints> magnitudeDb{}, phase{};
+};
\ No newline at end of file
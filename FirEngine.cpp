@@ -0,0 +1,346 @@
+// === File: FirEngine.cpp ===
+#include "FirEngine.h"
+
+void FirEngine::prepare(double newSampleRate, int newNumChannels, double maxSpanSeconds, int initialPartitions)
+{
+    sampleRate = newSampleRate;
+    numChannels = newNumChannels;
+    maxSpanSamples = static_cast<float>(sampleRate * maxSpanSeconds);
+    maxPartitions = getPartitionsForSpan(maxSpanSamples);
+
+    spareStore.reset();
+    spareFrames = -1;
+    partitionHandover.store(handoverIdle);
+    initialPartitions = juce::jmin(maxPartitions, initialPartitions);
+    store = initialPartitions > 0 ? makePartitionStore(initialPartitions) : nullptr;
+    activePartitions.store(initialPartitions);
+
+    fftBuffer.assign(static_cast<size_t>(2 * fftSize), 0.0f);
+    accumulator.assign(static_cast<size_t>(2 * fftSize), 0.0f);
+    tapDelays.assign(static_cast<size_t>(maxTaps), 0.0f);
+    tapGains.assign(static_cast<size_t>(maxTaps), 0.0f);
+    previousTapDelays.assign(static_cast<size_t>(maxTaps), 0.0f);
+    previousTapGains.assign(static_cast<size_t>(maxTaps), 0.0f);
+    numPreviousTaps = 0;
+    tapFade.prepare(sampleRate);
+
+    minKernelRebuildInterval = static_cast<int>(sampleRate * 0.02); // at most 50 rebuilds/s
+    requestedTaps = 0;
+    currentGain = currentSpacing = -1.0f;
+    reset();
+}
+
+void FirEngine::reset()
+{
+    // A spare being filled is cleared too; it then holds the same (silent) history
+    for (auto* partitions : { store.get(), spareFrames >= 0 ? spareStore.get() : nullptr })
+    {
+        if (partitions == nullptr)
+            continue;
+
+        for (auto& c : partitions->channels)
+        {
+            std::fill(c.input.begin(), c.input.end(), 0.0f);
+            std::fill(c.output.begin(), c.output.end(), 0.0f);
+            std::fill(c.spectra.begin(), c.spectra.end(), 0.0f);
+            c.slot = 0;
+        }
+    }
+    if (spareFrames >= 0 && store != nullptr)
+        spareFrames = store->capacity;
+    framePosition = 0;
+    tapFade.reset();
+    kernelDirty = true;
+    samplesSinceKernelBuild = minKernelRebuildInterval;
+}
+
+int FirEngine::getPartitionsForSpan(double spanSamples) noexcept
+{
+    // Kernel taps are drawn with linear interpolation, so allow one extra sample
+    const int kernelSamples = static_cast<int>(std::ceil(spanSamples)) + 2;
+    return (kernelSamples + partitionSize - 1) / partitionSize;
+}
+
+std::unique_ptr<FirEngine::PartitionStore> FirEngine::makePartitionStore(int capacity) const
+{
+    auto partitions = std::make_unique<PartitionStore>();
+    partitions->capacity = capacity;
+    partitions->kernelTime.assign(static_cast<size_t>(capacity * partitionSize), 0.0f);
+    partitions->kernelSpectra.assign(static_cast<size_t>(capacity * spectrumSize), 0.0f);
+    partitions->channels.resize(static_cast<size_t>(numChannels));
+    for (auto& c : partitions->channels)
+    {
+        c.input.assign(static_cast<size_t>(2 * partitionSize), 0.0f);
+        c.output.assign(static_cast<size_t>(partitionSize), 0.0f);
+        c.spectra.assign(static_cast<size_t>(capacity * spectrumSize), 0.0f);
+    }
+    return partitions;
+}
+
+void FirEngine::buildSparePartitions(int numPartitions)
+{
+    const int handover = partitionHandover.load(std::memory_order_acquire);
+    if (handover == handoverReady || numChannels == 0)
+        return;
+
+    if (handover == handoverRetired)
+    {
+        spareStore.reset();
+        partitionHandover.store(handoverIdle, std::memory_order_release);
+    }
+
+    numPartitions = juce::jmin(maxPartitions, numPartitions);
+    if (numPartitions <= activePartitions.load(std::memory_order_acquire))
+        return;
+
+    // Headroom, so a slow downward filterFreq sweep doesn't grow the store on every tick
+    spareStore = makePartitionStore(juce::jmin(maxPartitions, numPartitions + numPartitions / 2));
+    partitionHandover.store(handoverReady, std::memory_order_release);
+}
+
+void FirEngine::swapInSparePartitions() noexcept
+{
+    if (partitionHandover.load(std::memory_order_acquire) != handoverReady)
+        return;
+
+    // From here every frame goes into the spare as well; once it has taken as many frames as
+    // the active store holds, it carries the same history and takes over
+    if (spareFrames < 0)
+        spareFrames = 0;
+    if (store != nullptr && spareFrames < store->capacity)
+        return;
+
+    if (store != nullptr)
+    {
+        for (size_t ch = 0; ch < store->channels.size(); ++ch)
+        {
+            const auto& from = store->channels[ch];
+            auto& to = spareStore->channels[ch];
+            std::copy(from.input.begin(), from.input.end(), to.input.begin());
+            std::copy(from.output.begin(), from.output.end(), to.output.begin());
+        }
+    }
+
+    std::swap(store, spareStore);
+    spareFrames = -1;
+    activePartitions.store(store->capacity, std::memory_order_release);
+    partitionHandover.store(handoverRetired, std::memory_order_release);
+
+    // The new store's kernel is empty: render it now rather than after the rate limit
+    kernelDirty = true;
+    samplesSinceKernelBuild = minKernelRebuildInterval;
+}
+
+void FirEngine::setShape(int numTaps, float tapGain, float tapSpacingSamples)
+{
+    numTaps = juce::jlimit(1, maxTaps, numTaps);
+
+    if (numTaps != requestedTaps || tapGain != currentGain || tapSpacingSamples != currentSpacing)
+    {
+        // Direct path: the table holds still while a crossfade runs and catches up after it
+        const bool direct = ! partitioned && numTaps <= partitionedThreshold;
+        if (direct && tapFade.isFading())
+            return;
+
+        if (direct)
+        {
+            std::copy_n(tapDelays.begin(), numActiveTaps, previousTapDelays.begin());
+            std::copy_n(tapGains.begin(), numActiveTaps, previousTapGains.begin());
+            numPreviousTaps = numActiveTaps;
+        }
+
+        const bool wasPartitioned = partitioned;
+        rebuildTapTable(numTaps, tapGain, tapSpacingSamples);
+        partitioned = numTaps > partitionedThreshold;
+        kernelDirty = true;
+
+        // A different tap count, or the spacing moving the longest tap at all, crossfades from
+        // the previous table; a tapGain move alone snaps
+        if (! direct)
+            tapFade.reset();
+        else if (numActiveTaps != numPreviousTaps)
+            tapFade.jumpTo(getMaxTapDelay());
+        else
+            tapFade.setDelay(getMaxTapDelay());
+
+        // Entering the FFT path starts from silence rather than stale frames
+        if (partitioned && ! wasPartitioned)
+            reset();
+    }
+
+    if (partitioned && kernelDirty && samplesSinceKernelBuild >= minKernelRebuildInterval)
+        rebuildKernel();
+}
+
+void FirEngine::rebuildTapTable(int numTaps, float tapGain, float tapSpacingSamples)
+{
+    requestedTaps = numTaps;
+    currentGain = tapGain;
+    currentSpacing = tapSpacingSamples;
+
+    // Tap t sits t spacings back; drop taps that would reach past the supported span
+    int taps = numTaps;
+    if (tapSpacingSamples > 0.0f)
+        taps = juce::jmin(taps, 1 + static_cast<int>(maxSpanSamples / tapSpacingSamples));
+
+    numActiveTaps = 0;
+
+    // The Hann window is zero at both ends, so only interior taps are stored
+    for (int t = 1; t < taps - 1; ++t)
+    {
+        tapDelays[static_cast<size_t>(numActiveTaps)] = static_cast<float>(t) * tapSpacingSamples;
+        tapGains[static_cast<size_t>(numActiveTaps)] = getTapGain(t, taps, tapGain);
+        ++numActiveTaps;
+    }
+}
+
+float FirEngine::getTapGain(int tap, int numTaps, float tapGain) noexcept
+{
+    if (numTaps < 3)
+        return 0.0f;
+
+    const float frac_t = static_cast<float>(tap) / static_cast<float>(numTaps - 1);
+    const float window = 0.5f * (1.0f - std::cos(juce::MathConstants<float>::twoPi * frac_t));
+    return tapGain / static_cast<float>(numTaps) * window;
+}
+
+void FirEngine::rebuildKernel()
+{
+    if (store == nullptr)
+        return;
+
+    auto& kernelTime = store->kernelTime;
+
+    // Render the tap table into an impulse response, using the same linear interpolation
+    // as the direct path so switching paths doesn't change the sound
+    int kernelLength = 1;
+    for (int t = 0; t < numActiveTaps; ++t)
+        kernelLength = juce::jmax(kernelLength, static_cast<int>(tapDelays[static_cast<size_t>(t)]) + 2);
+
+    numPartitions = juce::jmin(store->capacity, (kernelLength + partitionSize - 1) / partitionSize);
+    std::fill(kernelTime.begin(), kernelTime.begin() + numPartitions * partitionSize, 0.0f);
+
+    const int kernelEnd = numPartitions * partitionSize;
+    for (int t = 0; t < numActiveTaps; ++t)
+    {
+        const float d = tapDelays[static_cast<size_t>(t)];
+        const float g = tapGains[static_cast<size_t>(t)];
+        const int di = static_cast<int>(d);
+        const float fd = d - static_cast<float>(di);
+        if (di < kernelEnd) kernelTime[static_cast<size_t>(di)] += g * (1.0f - fd);
+        if (di + 1 < kernelEnd) kernelTime[static_cast<size_t>(di + 1)] += g * fd;
+    }
+
+    for (int part = 0; part < numPartitions; ++part)
+    {
+        std::fill(fftBuffer.begin(), fftBuffer.end(), 0.0f);
+        std::copy_n(kernelTime.begin() + part * partitionSize, partitionSize, fftBuffer.begin());
+        fft.performRealOnlyForwardTransform(fftBuffer.data(), true);
+        std::copy_n(fftBuffer.begin(), spectrumSize, store->kernelSpectra.begin() + part * spectrumSize);
+    }
+
+    kernelDirty = false;
+    samplesSinceKernelBuild = 0;
+}
+
+template <typename SampleType>
+void FirEngine::processPartitioned(int channel, const SampleType* in, SampleType* wet, int numSamples)
+{
+    if (store == nullptr)
+    {
+        std::fill(wet, wet + numSamples, SampleType(0));
+        return;
+    }
+
+    auto& c = store->channels[static_cast<size_t>(channel)];
+    int pos = framePosition;
+    int done = 0;
+
+    while (done < numSamples)
+    {
+        const int len = juce::jmin(numSamples - done, partitionSize - pos);
+
+        // Output is exactly one partition behind the input
+        if constexpr (std::is_same_v<SampleType, float>)
+        {
+            juce::FloatVectorOperations::copy(c.input.data() + partitionSize + pos, in + done, len);
+            juce::FloatVectorOperations::copy(wet + done, c.output.data() + pos, len);
+        }
+        else
+        {
+            std::transform(in + done, in + done + len, c.input.begin() + partitionSize + pos, [](SampleType x) { return static_cast<float>(x); });
+            std::copy_n(c.output.begin() + pos, len, wet + done);
+        }
+
+        pos += len;
+        done += len;
+
+        if (pos == partitionSize)
+        {
+            processFrame(channel);
+            pos = 0;
+        }
+    }
+}
+
+template void FirEngine::processPartitioned<float>(int, const float*, float*, int);
+template void FirEngine::processPartitioned<double>(int, const double*, double*, int);
+
+void FirEngine::advance(int numSamples) noexcept
+{
+    if (spareFrames >= 0)
+        spareFrames += (framePosition + numSamples) / partitionSize;
+    framePosition = (framePosition + numSamples) % partitionSize;
+    tapFade.advance(numSamples);
+    samplesSinceKernelBuild = juce::jmin(samplesSinceKernelBuild + numSamples, minKernelRebuildInterval);
+}
+
+void FirEngine::processFrame(int channel)
+{
+    auto& c = store->channels[static_cast<size_t>(channel)];
+    const int capacity = store->capacity;
+
+    // Spectrum of the latest 2 * partitionSize input samples goes into the delay line
+    std::fill(fftBuffer.begin(), fftBuffer.end(), 0.0f);
+    std::copy(c.input.begin(), c.input.end(), fftBuffer.begin());
+    fft.performRealOnlyForwardTransform(fftBuffer.data(), true);
+
+    c.slot = (c.slot + 1) % capacity;
+    std::copy_n(fftBuffer.begin(), spectrumSize, c.spectra.begin() + c.slot * spectrumSize);
+
+    if (spareFrames >= 0)
+    {
+        auto& spare = spareStore->channels[static_cast<size_t>(channel)];
+        spare.slot = (spare.slot + 1) % spareStore->capacity;
+        std::copy_n(fftBuffer.begin(), spectrumSize, spare.spectra.begin() + spare.slot * spectrumSize);
+    }
+
+    // Y = sum_k X[n - k] * H[k]
+    std::fill(accumulator.begin(), accumulator.end(), 0.0f);
+    float* acc = accumulator.data();
+    for (int k = 0; k < numPartitions; ++k)
+    {
+        const int s = (c.slot - k + capacity) % capacity;
+        const float* x = c.spectra.data() + s * spectrumSize;
+        const float* h = store->kernelSpectra.data() + k * spectrumSize;
+
+        for (int b = 0; b < spectrumSize; b += 2)
+        {
+            acc[b]     += x[b] * h[b]     - x[b + 1] * h[b + 1];
+            acc[b + 1] += x[b] * h[b + 1] + x[b + 1] * h[b];
+        }
+    }
+
+    // Fill the conjugate-symmetric upper half expected by the inverse transform
+    for (int i = 1; i < fftSize / 2; ++i)
+    {
+        acc[2 * (fftSize - i)] = acc[2 * i];
+        acc[2 * (fftSize - i) + 1] = -acc[2 * i + 1];
+    }
+
+    fft.performRealOnlyInverseTransform(acc);
+
+    // Overlap-save: the second half of the circular result is valid
+    std::copy_n(accumulator.begin() + partitionSize, partitionSize, c.output.begin());
+    std::copy_n(c.input.begin() + partitionSize, partitionSize, c.input.begin());
+}
\ No newline at end of file
@@ -0,0 +1,118 @@
+// === File: FirEngine.h ===
+#pragma once
+
+#include <JuceHeader.h>
+#include "DelayLine.h"
+
+// FIR mode engine. Owns the Hann-windowed tap table (rebuilt only when taps/tapGain/spacing
+// change) and, above partitionedThreshold taps, a uniformly-partitioned overlap-save FFT
+// convolver that renders the same taps as a kernel. The direct path reads the table against
+// the processor's shared DelayLine; the partitioned path has partitionSize samples of latency.
+// The FFT runs in float; double-precision callers are converted at the partition buffers.
+// On the direct path a tap table that moves crossfades from the previous one (DelayTapFade).
+//
+// The partitioned path's kernel and spectra are only allocated once a shape needs them, for
+// that shape's span, and grow through the same handover as the processor's delay line:
+// buildSparePartitions on the message thread, swapInSparePartitions at the start of an audio
+// block. A spare takes every new frame alongside the active store and takes over once it holds
+// all the history the active one does, so nothing is copied in bulk on the audio thread. Until
+// then the kernel is cut to the active store (no store: silent wet).
+class FirEngine
+{
+public:
+    static constexpr int maxTaps = 1024;
+    static constexpr int partitionedThreshold = 64;
+    static constexpr int partitionSize = 256;
+
+    // numPartitions: the partitioned storage the current settings need (0 allocates none)
+    void prepare(double sampleRate, int numChannels, double maxSpanSeconds, int numPartitions);
+    void reset();
+
+    // Partitions a kernel spanning spanSamples needs
+    static int getPartitionsForSpan(double spanSamples) noexcept;
+    void buildSparePartitions(int numPartitions);
+    void swapInSparePartitions() noexcept;
+
+    // Updates the tap table when the shape changed; also refreshes the FFT kernel
+    // (rate-limited, so sweeping filterFreq doesn't rebuild it every block).
+    void setShape(int numTaps, float tapGain, float tapSpacingSamples);
+
+    int getNumActiveTaps() const noexcept { return numActiveTaps; }
+    const float* getTapDelays() const noexcept { return tapDelays.data(); }
+    const float* getTapGains() const noexcept { return tapGains.data(); }
+    float getMaxTapDelay() const noexcept { return numActiveTaps > 0 ? tapDelays[static_cast<size_t>(numActiveTaps - 1)] : 0.0f; }
+
+    // Direct path: while fading, the previous table is read too and weighted by 1 - gain
+    bool isFading() const noexcept { return tapFade.isFading(); }
+    int getNumPreviousTaps() const noexcept { return numPreviousTaps; }
+    const float* getPreviousTapDelays() const noexcept { return previousTapDelays.data(); }
+    const float* getPreviousTapGains() const noexcept { return previousTapGains.data(); }
+    template <typename SampleType>
+    void getFadeGains(SampleType* dest, int numSamples) const noexcept { tapFade.getGains(dest, numSamples); }
+
+    bool usesPartitionedPath() const noexcept { return partitioned; }
+    int getLatencySamples() const noexcept { return getLatencyForTaps(requestedTaps); }
+    static int getLatencyForTaps(int numTaps) noexcept { return numTaps > partitionedThreshold ? partitionSize : 0; }
+
+    // Hann-windowed gain of tap t (delay t * spacing) of numTaps, as stored in the tap table
+    static float getTapGain(int tap, int numTaps, float tapGain) noexcept;
+
+    // Partitioned path: writes the convolved block, getLatencySamples() behind the input, to
+    // wet. Call for every channel, then advance().
+    template <typename SampleType>
+    void processPartitioned(int channel, const SampleType* in, SampleType* wet, int numSamples);
+    void advance(int numSamples) noexcept;
+
+private:
+    static constexpr int fftOrder = 9; // 2 * partitionSize
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int spectrumSize = fftSize + 2; // bins 0..fftSize/2, interleaved re/im
+
+    void rebuildTapTable(int numTaps, float tapGain, float tapSpacingSamples);
+    void rebuildKernel();
+    void processFrame(int channel);
+
+    struct ChannelState
+    {
+        std::vector<float> input;  // previous + current partition (2 * partitionSize)
+        std::vector<float> output; // last valid overlap-save output (partitionSize)
+        std::vector<float> spectra; // frequency-domain delay line, capacity slots
+        int slot{ 0 };
+    };
+
+    // Kernel and per-channel state for up to capacity partitions
+    struct PartitionStore
+    {
+        int capacity{ 0 };
+        std::vector<float> kernelTime, kernelSpectra;
+        std::vector<ChannelState> channels;
+    };
+    std::unique_ptr<PartitionStore> makePartitionStore(int capacity) const;
+
+    juce::dsp::FFT fft{ fftOrder };
+    std::unique_ptr<PartitionStore> store, spareStore;
+    int spareFrames{ -1 }; // frames a ready spare has taken alongside store, -1 before it starts
+    enum { handoverIdle = 0, handoverReady, handoverRetired };
+    std::atomic<int> partitionHandover{ handoverIdle };
+    std::atomic<int> activePartitions{ 0 };
+    int numChannels{ 0 };
+    std::vector<float> fftBuffer, accumulator;
+    std::vector<float> tapDelays, tapGains;
+    std::vector<float> previousTapDelays, previousTapGains;
+    int numPreviousTaps{ 0 };
+    DelayTapFade tapFade; // tracks the longest tap's delay
+
+    double sampleRate{ 44100.0 };
+    float maxSpanSamples{ 44100.0f };
+    int maxPartitions{ 1 };
+    int numPartitions{ 0 };
+    int framePosition{ 0 };
+
+    int requestedTaps{ 0 };
+    float currentGain{ -1.0f }, currentSpacing{ -1.0f };
+    int numActiveTaps{ 0 };
+    bool partitioned{ false };
+    bool kernelDirty{ true };
+    int samplesSinceKernelBuild{ 0 };
+    int minKernelRebuildInterval{ 0 };
+};
\ No newline at end of file
@@ -0,0 +1,147 @@
+// === File: ModulationSource.h ===
+#pragma once
+
+#include <JuceHeader.h>
+
+// Block-rendering LFO for the phaser/flanger kernels. The waveform is evaluated from a sine
+// table (no transcendental calls) once per control interval and linearly interpolated in
+// between, so the per-sample cost is a multiply-add. Channel c runs c * stereoOffset cycles
+// ahead of channel 0. Output range is [-1, 1].
+class ModulationSource
+{
+public:
+    enum class Shape { sine = 0, triangle, sampleAndHold };
+
+    static constexpr int maxChannels = 16;
+
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        getSineTable(); // build the shared table off the audio thread
+        reset();
+    }
+
+    void reset()
+    {
+        phase = 0.0;
+        samplesUntilUpdate = 0;
+        for (int ch = 0; ch < maxChannels; ++ch)
+        {
+            heldValue[ch] = 0.0f;
+            current[ch] = evaluate(ch, channelPhase(ch));
+            slope[ch] = 0.0f;
+        }
+    }
+
+    void setRate(float hz) noexcept { increment = static_cast<double>(hz) / sampleRate; }
+    void setShape(Shape newShape) noexcept { shape = newShape; }
+
+    // Offset in cycles (0.5 = 180 degrees between channels)
+    void setStereoOffset(float cycles) noexcept { stereoOffset = static_cast<double>(cycles); }
+
+    // 1 = evaluate every sample; larger values trade sweep resolution for CPU
+    void setControlInterval(int samples) noexcept { controlInterval = juce::jmax(1, samples); }
+
+    // Renders numSamples of modulation into dest[0..numChannels)
+    void process(float* const* dest, int numChannels, int numSamples) noexcept
+    {
+        jassert(numChannels <= maxChannels);
+
+        int i = 0;
+        while (i < numSamples)
+        {
+            if (samplesUntilUpdate == 0)
+                startSegment(numChannels);
+
+            const int len = juce::jmin(samplesUntilUpdate, numSamples - i);
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                const float v = current[ch];
+                const float s = slope[ch];
+                float* d = dest[ch] + i;
+                for (int k = 0; k < len; ++k)
+                    d[k] = v + s * static_cast<float>(k);
+                current[ch] = v + s * static_cast<float>(len);
+            }
+
+            i += len;
+            samplesUntilUpdate -= len;
+        }
+    }
+
+    // Keeps the phase running while no kernel consumes the output
+    void advance(int numSamples) noexcept
+    {
+        phase = wrap(phase + increment * static_cast<double>(numSamples));
+        samplesUntilUpdate = 0;
+        for (int ch = 0; ch < maxChannels; ++ch)
+            current[ch] = evaluate(ch, channelPhase(ch));
+    }
+
+private:
+    static constexpr int tableSize = 2048;
+    using SineTable = std::array<float, tableSize + 1>;
+
+    static const SineTable& getSineTable()
+    {
+        static const SineTable table = []
+        {
+            SineTable t{};
+            for (int i = 0; i <= tableSize; ++i)
+                t[static_cast<size_t>(i)] = static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * i / tableSize));
+            return t;
+        }();
+        return table;
+    }
+
+    static double wrap(double p) noexcept { return p - std::floor(p); }
+
+    double channelPhase(int ch) const noexcept { return wrap(phase + stereoOffset * ch); }
+
+    void startSegment(int numChannels) noexcept
+    {
+        const double step = increment * static_cast<double>(controlInterval);
+        phase = wrap(phase + step);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const double p = channelPhase(ch);
+            if (shape == Shape::sampleAndHold && p < step)
+                heldValue[ch] = random.nextFloat() * 2.0f - 1.0f; // channel phase wrapped: new value
+            const float target = evaluate(ch, p);
+            slope[ch] = (target - current[ch]) / static_cast<float>(controlInterval);
+        }
+        samplesUntilUpdate = controlInterval;
+    }
+
+    float evaluate(int ch, double p) const noexcept
+    {
+        switch (shape)
+        {
+        case Shape::triangle:
+        {
+            const float x = static_cast<float>(p);
+            return x < 0.25f ? 4.0f * x : (x < 0.75f ? 2.0f - 4.0f * x : 4.0f * x - 4.0f);
+        }
+        case Shape::sampleAndHold:
+            return heldValue[ch];
+        case Shape::sine:
+        default:
+        {
+            const auto& table = getSineTable();
+            const double pos = p * tableSize;
+            const int idx = static_cast<int>(pos);
+            const float frac = static_cast<float>(pos - idx);
+            return table[static_cast<size_t>(idx)] + frac * (table[static_cast<size_t>(idx + 1)] - table[static_cast<size_t>(idx)]);
+        }
+        }
+    }
+
+    double sampleRate{ 44100.0 };
+    double phase{ 0.0 }, increment{ 0.0 }, stereoOffset{ 0.0 };
+    Shape shape{ Shape::sine };
+    int controlInterval{ 1 };
+    int samplesUntilUpdate{ 0 };
+    float current[maxChannels]{}, slope[maxChannels]{}, heldValue[maxChannels]{};
+    juce::Random random;
+};
\ No newline at end of file
@@ -0,0 +1,289 @@
+// === File: OfflineRenderer.cpp ===
+// Headless batch renderer: streams WAV/AIFF files through DelayFilterPluginAudioProcessor in
+// offline (non-realtime) mode and writes the processed files. Files are spread over a pool of
+// workers, each owning its own processor instance, and throughput stats are printed at the end.
+//
+//   DelayFilterRender [--state <state.bin> | --params <params.json>] [--threads N]
+//                     [--output-dir <dir>] <input files...>
+//
+// --params takes { "parameterID": value, ... } in plain units (choices by index), the same
+// form the benchmark uses; it is turned into a state blob and loaded like --state.
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include <chrono>
+#include <thread>
+
+namespace
+{
+    // Samples read, processed and written per call; processBlock splits it into prepared sub-blocks
+    constexpr int renderChunkSize = 65536;
+    constexpr int processorBlockSize = 2048;
+
+    struct FileResult
+    {
+        juce::File input, output;
+        double audioSeconds{ 0.0 }, wallSeconds{ 0.0 };
+        juce::String error;
+    };
+
+    juce::CriticalSection logLock;
+
+    void log(const juce::String& message)
+    {
+        const juce::ScopedLock sl(logLock);
+        std::fprintf(stderr, "%s\n", message.toRawUTF8());
+    }
+
+    bool makeStateFromJson(const juce::File& file, juce::MemoryBlock& state)
+    {
+        const auto json = juce::JSON::parse(file);
+        auto* object = json.getDynamicObject();
+        if (object == nullptr)
+            return false;
+
+        DelayFilterPluginAudioProcessor reference;
+        for (const auto& property : object->getProperties())
+        {
+            auto* param = reference.apvts.getParameter(property.name.toString());
+            if (param == nullptr)
+            {
+                log("Unknown parameter: " + property.name.toString());
+                return false;
+            }
+            param->setValueNotifyingHost(param->convertTo0to1(static_cast<float>(property.value)));
+        }
+
+        reference.getStateInformation(state);
+        return true;
+    }
+
+    // Memory-mapped where the format supports it, streamed otherwise
+    std::unique_ptr<juce::AudioFormatReader> openReader(juce::AudioFormat& format, const juce::File& file)
+    {
+        std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped(format.createMemoryMappedReader(file));
+        if (mapped != nullptr && mapped->mapEntireFile())
+            return mapped;
+
+        return std::unique_ptr<juce::AudioFormatReader>(format.createReaderFor(new juce::FileInputStream(file), true));
+    }
+
+    class RenderWorker
+    {
+    public:
+        explicit RenderWorker(const juce::MemoryBlock& state)
+        {
+            formatManager.registerBasicFormats();
+            processor.setNonRealtime(true);
+            if (state.getSize() > 0)
+                processor.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+        }
+
+        void render(FileResult& result)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            result.error = renderFile(result);
+            result.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+
+    private:
+        juce::String renderFile(FileResult& result)
+        {
+            auto* format = formatManager.findFormatForFileExtension(result.input.getFileExtension());
+            if (format == nullptr)
+                return "unsupported format";
+
+            auto reader = openReader(*format, result.input);
+            if (reader == nullptr)
+                return "could not open";
+
+            const int numChannels = static_cast<int>(reader->numChannels);
+            const double sampleRate = reader->sampleRate;
+            if (! prepare(numChannels, sampleRate))
+                return "unsupported channel count " + juce::String(numChannels);
+
+            result.output.deleteFile();
+            std::unique_ptr<juce::FileOutputStream> stream = result.output.createOutputStream();
+            if (stream == nullptr || stream->failedToOpen())
+                return "could not create " + result.output.getFullPathName();
+
+            std::unique_ptr<juce::AudioFormatWriter> writer(format->createWriterFor(stream.get(), sampleRate, static_cast<unsigned int>(numChannels),
+                                                                                    static_cast<int>(reader->bitsPerSample), reader->metadataValues, 0));
+            if (writer == nullptr)
+                return "could not create writer";
+            stream.release(); // owned by the writer now
+
+            // Render past the end by the reported latency (trimmed from the front) plus the tail
+            const juce::int64 length = reader->lengthInSamples;
+            const juce::int64 latency = processor.getLatencySamples();
+            const juce::int64 tail = static_cast<juce::int64>(processor.getTailLengthSeconds() * sampleRate);
+            const juce::int64 total = length + latency + tail;
+            juce::int64 toSkip = latency;
+            juce::MidiBuffer midi;
+
+            for (juce::int64 pos = 0; pos < total; pos += renderChunkSize)
+            {
+                const int n = static_cast<int>(juce::jmin<juce::int64>(renderChunkSize, total - pos));
+                juce::AudioBuffer<float> block(chunk.getArrayOfWritePointers(), numChannels, n);
+                block.clear();
+                if (pos < length)
+                    reader->read(&block, 0, static_cast<int>(juce::jmin<juce::int64>(n, length - pos)), pos, true, true);
+
+                processor.processBlock(block, midi);
+
+                const int skip = static_cast<int>(juce::jmin<juce::int64>(toSkip, n));
+                toSkip -= skip;
+                if (n > skip && ! writer->writeFromAudioSampleBuffer(block, skip, n - skip))
+                    return "write failed";
+            }
+
+            result.audioSeconds = static_cast<double>(length) / sampleRate;
+            return {};
+        }
+
+        // Prepared for every file, which also clears the previous file's delay and filter state
+        bool prepare(int numChannels, double sampleRate)
+        {
+            processor.releaseResources();
+            processor.setPlayConfigDetails(numChannels, numChannels, sampleRate, processorBlockSize);
+            if (processor.getMainBusNumOutputChannels() != numChannels)
+                return false;
+
+            processor.prepareToPlay(sampleRate, processorBlockSize);
+            chunk.setSize(numChannels, renderChunkSize, false, false, true);
+            return true;
+        }
+
+        DelayFilterPluginAudioProcessor processor;
+        juce::AudioFormatManager formatManager;
+        juce::AudioBuffer<float> chunk;
+    };
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i)
+        args.add(argv[i]);
+
+    juce::MemoryBlock state;
+    juce::File outputDir;
+    int numThreads = juce::SystemStats::getNumCpus();
+    std::vector<FileResult> jobs;
+
+    for (int i = 0; i < args.size(); ++i)
+    {
+        const auto& arg = args[i];
+        const bool hasValue = i + 1 < args.size();
+        const auto file = [&] { return juce::File::getCurrentWorkingDirectory().getChildFile(args[++i]); };
+
+        if (arg == "--state" && hasValue)
+        {
+            if (! file().loadFileAsData(state))
+            {
+                log("Could not read state file " + args[i]);
+                return 1;
+            }
+        }
+        else if (arg == "--params" && hasValue)
+        {
+            if (! makeStateFromJson(file(), state))
+            {
+                log("Could not load parameters from " + args[i]);
+                return 1;
+            }
+        }
+        else if (arg == "--threads" && hasValue)
+        {
+            numThreads = juce::jmax(1, args[++i].getIntValue());
+        }
+        else if (arg == "--output-dir" && hasValue)
+        {
+            outputDir = file();
+        }
+        else
+        {
+            FileResult job;
+            job.input = juce::File::getCurrentWorkingDirectory().getChildFile(arg);
+            jobs.push_back(job);
+        }
+    }
+
+    if (jobs.empty())
+    {
+        log("Usage: DelayFilterRender [--state <state.bin> | --params <params.json>] [--threads N] [--output-dir <dir>] <input files...>");
+        return 1;
+    }
+
+    if (outputDir != juce::File() && ! outputDir.createDirectory())
+    {
+        log("Could not create " + outputDir.getFullPathName());
+        return 1;
+    }
+
+    for (auto& job : jobs)
+    {
+        const auto name = job.input.getFileNameWithoutExtension() + "_processed" + job.input.getFileExtension();
+        job.output = (outputDir != juce::File() ? outputDir : job.input.getParentDirectory()).getChildFile(name);
+    }
+
+    numThreads = juce::jmin(numThreads, static_cast<int>(jobs.size()));
+
+    // Processors are created here on the message thread; workers only prepare and render
+    std::vector<std::unique_ptr<RenderWorker>> workers;
+    for (int w = 0; w < numThreads; ++w)
+        workers.push_back(std::make_unique<RenderWorker>(state));
+
+    std::atomic<size_t> nextJob{ 0 };
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (auto& worker : workers)
+    {
+        threads.emplace_back([&, w = worker.get()]
+        {
+            for (size_t index = nextJob++; index < jobs.size(); index = nextJob++)
+            {
+                auto& job = jobs[index];
+                w->render(job);
+
+                if (job.error.isNotEmpty())
+                    log(job.input.getFileName() + ": " + job.error);
+                else
+                    log(job.input.getFileName() + " -> " + job.output.getFileName() + juce::String::formatted("  x%.1f realtime", job.audioSeconds / job.wallSeconds));
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    const double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    int numRendered = 0;
+    double audioSeconds = 0.0;
+    std::vector<double> factors;
+    for (const auto& job : jobs)
+    {
+        if (job.error.isNotEmpty())
+            continue;
+        ++numRendered;
+        audioSeconds += job.audioSeconds;
+        factors.push_back(job.audioSeconds / juce::jmax(1.0e-9, job.wallSeconds));
+    }
+
+    std::printf("files: %d rendered, %d failed, %d threads\n", numRendered, static_cast<int>(jobs.size()) - numRendered, numThreads);
+    std::printf("wall: %.2f s, audio: %.2f s, %.2f files/s\n", wallSeconds, audioSeconds, numRendered / wallSeconds);
+    std::printf("realtime factor: x%.1f overall", audioSeconds / wallSeconds);
+
+    if (! factors.empty())
+    {
+        // Per-file factors are single-threaded; the overall figure includes the parallelism
+        std::sort(factors.begin(), factors.end());
+        std::printf(", per file min x%.1f / median x%.1f / max x%.1f", factors.front(), factors[factors.size() / 2], factors.back());
+    }
+    std::printf("\n");
+
+    return numRendered == static_cast<int>(jobs.size()) ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,163 @@
+// === File: PhaserEngine.h ===
+#pragma once
+
+#include <JuceHeader.h>
+
+// Phaser mode engine: 2 to maxStages cascaded first-order allpasses with optional stage spread
+// (stage centres fanned out around the base frequency) and feedback from the last stage back
+// into the first. Channels are packed into SIMD lanes and every stage of a lane group keeps its
+// state and coefficient in one register, so a sample is one short chain of vector
+// multiply-adds per stage. Coefficients are recomputed from the LFO once per control interval
+// and ramped linearly in between, which keeps the per-sample loop free of scalar work.
+template <typename SampleType>
+class PhaserEngine
+{
+public:
+    static constexpr int maxStages = 12;
+    static constexpr float maxCoefficient = 0.99f;
+    static constexpr float spreadOctaves = 3.0f; // full spread: stages cover +-1.5 octaves
+
+    void prepare(int numChannels)
+    {
+        numGroups = (numChannels + lanes - 1) / lanes;
+        state.assign(static_cast<size_t>(numGroups * maxStages * 2), Vec());
+        coeffs.assign(static_cast<size_t>(numGroups * maxStages), Vec());
+        coeffSteps.assign(static_cast<size_t>(numGroups * maxStages), Vec());
+        lastOutput.assign(static_cast<size_t>(numGroups), Vec());
+        reset();
+    }
+
+    void reset()
+    {
+        std::fill(state.begin(), state.end(), Vec::expand(SampleType(0)));
+        std::fill(lastOutput.begin(), lastOutput.end(), Vec::expand(SampleType(0)));
+        coefficientsValid = false;
+    }
+
+    void setNumStages(int stages) noexcept { numStages = juce::jlimit(1, maxStages, stages); }
+
+    // Once per block: per-stage centre coefficients at the kernel's sample rate
+    void setFrequency(float freqHz, float spread, double sampleRate) noexcept
+    {
+        for (int stage = 0; stage < numStages; ++stage)
+            baseCoefficients[stage] = getBaseCoefficient(stage, numStages, freqHz, spread, sampleRate);
+    }
+
+    // Unmodulated coefficient a of one stage, H(z) = (a + z^-1) / (1 + a z^-1)
+    static float getBaseCoefficient(int stage, int stages, float freqHz, float spread, double sampleRate) noexcept
+    {
+        const float position = stages > 1 ? static_cast<float>(stage) / static_cast<float>(stages - 1) - 0.5f : 0.0f;
+        const double f = juce::jlimit(1.0, 0.49 * sampleRate, freqHz * std::exp2(static_cast<double>(spread * spreadOctaves * position)));
+        const double tanHalf = std::tan(juce::MathConstants<double>::pi * f / sampleRate);
+        return static_cast<float>((1.0 - tanHalf) / (1.0 + tanHalf));
+    }
+
+    // Filters channels in place. mod holds one LFO channel per audio channel; each stage's
+    // coefficient is base + mod * depth[i] * modScale. wet = in + (allpass - in) * blend[i].
+    void process(SampleType* const* channels, int numChannels, const float* const* mod, const float* depth, float modScale,
+                 const float* blend, float feedback, int controlInterval, int numSamples) noexcept
+    {
+        const auto fb = Vec::expand(static_cast<SampleType>(feedback));
+
+        for (int start = 0; start < numSamples; start += controlInterval)
+        {
+            const int len = juce::jmin(controlInterval, numSamples - start);
+            updateCoefficients(numChannels, mod, depth, modScale, start + len - 1, len);
+
+            for (int group = 0; group < numGroups; ++group)
+            {
+                const int firstChannel = group * lanes;
+                const int groupChannels = juce::jmin(lanes, numChannels - firstChannel);
+                if (groupChannels <= 0)
+                    break;
+
+                processGroup(channels + firstChannel, groupChannels, group, blend, fb, start, len);
+            }
+        }
+    }
+
+    // Samples for the impulse response to fall to level: each allpass pole is at most
+    // maxCoefficient, and feedback stretches the decay by 1 / (1 - |feedback|)
+    static double getDecaySamples(int stages, float feedback, double level) noexcept
+    {
+        const double perStage = std::log(level) / std::log(static_cast<double>(maxCoefficient));
+        return stages * perStage / (1.0 - juce::jmin(0.99, std::abs(static_cast<double>(feedback))));
+    }
+
+private:
+    using Vec = juce::dsp::SIMDRegister<SampleType>;
+    static constexpr int lanes = static_cast<int>(Vec::size());
+
+    // Targets for the end of the segment; the registers ramp there from where they are now
+    void updateCoefficients(int numChannels, const float* const* mod, const float* depth, float modScale, int end, int len) noexcept
+    {
+        alignas(Vec::SIMDRegisterSize) SampleType target[lanes] = {};
+        const auto stepScale = static_cast<SampleType>(1) / static_cast<SampleType>(len);
+
+        for (int group = 0; group < numGroups; ++group)
+        {
+            const int firstChannel = group * lanes;
+            const int groupChannels = juce::jmin(lanes, numChannels - firstChannel);
+
+            for (int stage = 0; stage < numStages; ++stage)
+            {
+                for (int c = 0; c < groupChannels; ++c)
+                    target[c] = static_cast<SampleType>(juce::jlimit(-maxCoefficient, maxCoefficient,
+                                                                     baseCoefficients[stage] + mod[firstChannel + c][end] * depth[end] * modScale));
+
+                const auto index = static_cast<size_t>(group * maxStages + stage);
+                const Vec t = Vec::fromRawArray(target);
+                if (! coefficientsValid)
+                    coeffs[index] = t;
+                coeffSteps[index] = (t - coeffs[index]) * stepScale;
+            }
+        }
+        coefficientsValid = true;
+    }
+
+    void processGroup(SampleType* const* channels, int groupChannels, int group, const float* blend, Vec fb, int start, int len) noexcept
+    {
+        alignas(Vec::SIMDRegisterSize) SampleType io[lanes] = {};
+        Vec* st = state.data() + group * maxStages * 2;
+        Vec* a = coeffs.data() + group * maxStages;
+        const Vec* da = coeffSteps.data() + group * maxStages;
+        Vec last = lastOutput[static_cast<size_t>(group)];
+
+        for (int i = start; i < start + len; ++i)
+        {
+            for (int c = 0; c < groupChannels; ++c)
+                io[c] = channels[c][i];
+
+            const Vec in = Vec::fromRawArray(io);
+            Vec x = in + fb * last;
+
+            for (int stage = 0; stage < numStages; ++stage)
+            {
+                Vec& x1 = st[stage * 2];
+                Vec& y1 = st[stage * 2 + 1];
+                a[stage] = a[stage] + da[stage];
+                const Vec y = x1 + a[stage] * (x - y1);
+                x1 = x;
+                y1 = y;
+                x = y;
+            }
+
+            last = x;
+            const Vec wet = in + (x - in) * static_cast<SampleType>(blend[i]);
+
+            wet.copyToRawArray(io);
+            for (int c = 0; c < groupChannels; ++c)
+                channels[c][i] = io[c];
+        }
+
+        lastOutput[static_cast<size_t>(group)] = last;
+    }
+
+    int numStages{ 2 };
+    int numGroups{ 0 };
+    float baseCoefficients[maxStages]{};
+    bool coefficientsValid{ false };
+    std::vector<Vec> state;              // x1/y1 per (group, stage)
+    std::vector<Vec> coeffs, coeffSteps; // per (group, stage), one lane per channel
+    std::vector<Vec> lastOutput;         // feedback source, per group
+};
\ No newline at end of file
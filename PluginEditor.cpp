@@ -4,7 +4,8 @@
 DelayFilterPluginAudioProcessorEditor::DelayFilterPluginAudioProcessorEditor(DelayFilterPluginAudioProcessor& p)
     : AudioProcessorEditor(&p), audioProcessor(p)
 {
-    setSize(600, 400);
+    setSize(600, CpuMeter::enabled ? 740 : 640);
+    addAndMakeVisible(responseView);
 
     // Filter choice
     filterChoice.addItem("Comb", 1);
@@ -22,6 +23,82 @@ DelayFilterPluginAudioProcessorEditor::DelayFilterPluginAudioProcessorEditor(Del
     addAndMakeVisible(iirTypeChoice);
     iirTypeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(audioProcessor.apvts, "iirType", iirTypeChoice);
 
+    // IIR slope choice
+    iirSlopeChoice.addItem("12 dB/oct", 1);
+    iirSlopeChoice.addItem("24 dB/oct", 2);
+    addAndMakeVisible(iirSlopeChoice);
+    iirSlopeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(audioProcessor.apvts, "iirSlope", iirSlopeChoice);
+
+    // LFO shape choice
+    lfoShapeChoice.addItem("Sine", 1);
+    lfoShapeChoice.addItem("Triangle", 2);
+    lfoShapeChoice.addItem("S&H", 3);
+    addAndMakeVisible(lfoShapeChoice);
+    lfoShapeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(audioProcessor.apvts, "lfoShape", lfoShapeChoice);
+
+    // Oversampling (comb / phaser / flanger), realtime and offline render
+    oversamplingChoice.addItem("1x", 1);
+    oversamplingChoice.addItem("2x", 2);
+    oversamplingChoice.addItem("4x", 3);
+    oversamplingChoice.addItem("8x", 4);
+    addAndMakeVisible(oversamplingChoice);
+    oversamplingAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(audioProcessor.apvts, "oversampling", oversamplingChoice);
+
+    offlineOversamplingChoice.addItem("Offline: as realtime", 1);
+    offlineOversamplingChoice.addItem("Offline: 1x", 2);
+    offlineOversamplingChoice.addItem("Offline: 2x", 3);
+    offlineOversamplingChoice.addItem("Offline: 4x", 4);
+    offlineOversamplingChoice.addItem("Offline: 8x", 5);
+    addAndMakeVisible(offlineOversamplingChoice);
+    offlineOversamplingAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(audioProcessor.apvts, "offlineOversampling", offlineOversamplingChoice);
+
+    delayStorageChoice.addItem("Delay: full precision", 1);
+    delayStorageChoice.addItem("Delay: compact 16-bit", 2);
+    addAndMakeVisible(delayStorageChoice);
+    delayStorageAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(audioProcessor.apvts, "delayStorage", delayStorageChoice);
+
+    phaserStagesChoice.addItem("Phaser: 2 stages", 1);
+    phaserStagesChoice.addItem("Phaser: 4 stages", 2);
+    phaserStagesChoice.addItem("Phaser: 8 stages", 3);
+    phaserStagesChoice.addItem("Phaser: 12 stages", 4);
+    addAndMakeVisible(phaserStagesChoice);
+    phaserStagesAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(audioProcessor.apvts, "phaserStages", phaserStagesChoice);
+
+    // Routing and chain slots; the slots only apply with routing set to Chain
+    routingChoice.addItem("Single mode", 1);
+    routingChoice.addItem("Chain", 2);
+    addAndMakeVisible(routingChoice);
+    routingAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(audioProcessor.apvts, "routing", routingChoice);
+
+    for (int slot = 0; slot < 4; ++slot)
+    {
+        auto& choice = chainStageChoices[slot];
+        choice.addItemList({ "Off", "Comb", "FIR", "IIR", "Phaser", "Flanger" }, 1);
+        addAndMakeVisible(choice);
+        chainStageAttachments[slot] = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(audioProcessor.apvts,
+                                                                                                             "chainStage" + juce::String(slot + 1), choice);
+    }
+
+    // Presets switch on the message thread; the audio thread only sees new parameter values
+    refreshPresetList();
+    presetChoice.onChange = [this]
+        {
+            if (const int index = presetChoice.getSelectedItemIndex(); index >= 0 && index != audioProcessor.getCurrentProgram())
+                audioProcessor.setCurrentProgram(index);
+        };
+    addAndMakeVisible(presetChoice);
+    savePresetButton.onClick = [this] { savePreset(); };
+    addAndMakeVisible(savePresetButton);
+
+    if (CpuMeter::enabled)
+    {
+        dumpCpuStatsButton.onClick = [this] { dumpCpuStats(); };
+        addAndMakeVisible(dumpCpuStatsButton);
+        resetCpuStatsButton.onClick = [this] { audioProcessor.getCpuMeter().resetStats(); repaint(cpuMeterArea); };
+        addAndMakeVisible(resetCpuStatsButton);
+        startTimerHz(10);
+    }
+
     auto makeSlider = [&](juce::Slider& s, const juce::String& paramID, const juce::String& name, std::unique_ptr<Attachment>& attach)
         {
             (void)name; // unreferenced
@@ -40,39 +117,189 @@ DelayFilterPluginAudioProcessorEditor::DelayFilterPluginAudioProcessorEditor(Del
     makeSlider(iirQSlider, "iirQ", "IIR Q", iirQAttachment);
     makeSlider(lfoRateSlider, "lfoRate", "LFO Rate", lfoRateAttachment);
     makeSlider(lfoDepthSlider, "lfoDepth", "LFO Depth", lfoDepthAttachment);
+    makeSlider(lfoStereoSlider, "lfoStereo", "LFO Stereo", lfoStereoAttachment);
+    makeSlider(phaserSpreadSlider, "phaserSpread", "Phaser Spread", phaserSpreadAttachment);
+    makeSlider(phaserFeedbackSlider, "phaserFeedback", "Phaser Feedback", phaserFeedbackAttachment);
 }
 
 DelayFilterPluginAudioProcessorEditor::~DelayFilterPluginAudioProcessorEditor() = default;
 
+void DelayFilterPluginAudioProcessorEditor::refreshPresetList()
+{
+    auto& bank = audioProcessor.getPresetBank();
+    presetChoice.clear(juce::dontSendNotification);
+    for (int i = 0; i < bank.getNumPresets(); ++i)
+        presetChoice.addItem(bank.getPresetName(i), i + 1);
+    presetChoice.setSelectedItemIndex(bank.getCurrentPreset(), juce::dontSendNotification);
+}
+
+void DelayFilterPluginAudioProcessorEditor::savePreset()
+{
+    auto* window = new juce::AlertWindow("Save preset", "Name for the new user preset:", juce::MessageBoxIconType::NoIcon, this);
+    window->addTextEditor("name", presetChoice.getText());
+    window->addButton("Save", 1, juce::KeyPress(juce::KeyPress::returnKey));
+    window->addButton("Cancel", 0, juce::KeyPress(juce::KeyPress::escapeKey));
+
+    juce::Component::SafePointer<DelayFilterPluginAudioProcessorEditor> editor(this);
+    window->enterModalState(true, juce::ModalCallbackFunction::create([editor, window](int result)
+        {
+            if (editor != nullptr && result == 1)
+            {
+                editor->audioProcessor.getPresetBank().saveUserPreset(window->getTextEditorContents("name"));
+                editor->refreshPresetList();
+            }
+        }), true);
+}
+
+void DelayFilterPluginAudioProcessorEditor::timerCallback()
+{
+    // The processor's timer drains the meter FIFO; this only redraws
+    repaint(cpuMeterArea);
+}
+
+void DelayFilterPluginAudioProcessorEditor::dumpCpuStats()
+{
+    const auto defaultFile = juce::File::getSpecialLocation(juce::File::userDocumentsDirectory)
+                                 .getChildFile("DelayFilterPlugin-cpu-" + juce::Time::getCurrentTime().formatted("%Y%m%d-%H%M%S") + ".json");
+    cpuStatsChooser = std::make_unique<juce::FileChooser>("Save CPU statistics", defaultFile, "*.json");
+
+    juce::Component::SafePointer<DelayFilterPluginAudioProcessorEditor> editor(this);
+    cpuStatsChooser->launchAsync(juce::FileBrowserComponent::saveMode | juce::FileBrowserComponent::canSelectFiles
+                                     | juce::FileBrowserComponent::warnAboutOverwriting,
+        [editor](const juce::FileChooser& chooser)
+        {
+            const auto file = chooser.getResult();
+            if (editor != nullptr && file != juce::File() && ! editor->audioProcessor.getCpuMeter().dumpToFile(file))
+                juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::WarningIcon, "Save CPU statistics",
+                                                       "Could not write " + file.getFullPathName());
+        });
+}
+
 void DelayFilterPluginAudioProcessorEditor::paint(juce::Graphics& g)
 {
     g.fillAll(juce::Colours::darkslategrey);
     g.setColour(juce::Colours::white);
     g.setFont(15.0f);
     g.drawFittedText("Delay-Filter Plugin (JUCE)", getLocalBounds().reduced(10, 10), juce::Justification::centredTop, 1);
+
+    if (CpuMeter::enabled)
+        paintCpuMeter(g);
+}
+
+void DelayFilterPluginAudioProcessorEditor::paintCpuMeter(juce::Graphics& g)
+{
+    const auto& stats = audioProcessor.getCpuMeter().getStats();
+    g.setColour(juce::Colours::black.withAlpha(0.25f));
+    g.fillRect(cpuMeterArea);
+    auto area = cpuMeterArea.reduced(6);
+
+    // Totals and per-mode cost (ns per sample)
+    juce::int64 blocks = 0, overBudget = 0, samples = 0;
+    double totalNs = 0.0;
+    juce::String modes;
+    for (int c = 0; c < CpuMeter::numCategories; ++c)
+    {
+        const auto& s = stats.categories[c];
+        blocks += s.blocks;
+        overBudget += s.overBudget;
+        samples += s.samples;
+        totalNs += s.totalNs;
+        if (s.samples > 0)
+            modes << CpuMeter::getCategoryName(c) << " " << juce::String(s.totalNs / static_cast<double>(s.samples), 1) << "   ";
+    }
+
+    g.setColour(juce::Colours::white);
+    g.setFont(12.0f);
+    g.drawText("CPU " + juce::String(stats.recentLoad * 100.0, 2) + "% (peak " + juce::String(stats.recentPeakLoad * 100.0, 1) + "%)   "
+                   + juce::String(samples > 0 ? totalNs / static_cast<double>(samples) : 0.0, 1) + " ns/sample   "
+                   + juce::String(overBudget) + " of " + juce::String(blocks) + " blocks over budget",
+               area.removeFromTop(16), juce::Justification::centredLeft);
+    g.drawText("ns/sample by mode:   " + modes, area.removeFromTop(16), juce::Justification::centredLeft);
+
+    // Load bar with a peak marker, full width = the block's real-time budget
+    auto bar = area.removeFromTop(8);
+    g.setColour(juce::Colours::white.withAlpha(0.15f));
+    g.fillRect(bar);
+    g.setColour(stats.recentPeakLoad > 1.0 ? juce::Colours::red : juce::Colours::limegreen);
+    g.fillRect(bar.withWidth(juce::roundToInt(bar.getWidth() * juce::jmin(1.0, stats.recentLoad))));
+    g.setColour(juce::Colours::orange);
+    g.fillRect(bar.getX() + juce::roundToInt((bar.getWidth() - 2) * juce::jmin(1.0, stats.recentPeakLoad)), bar.getY(), 2, bar.getHeight());
+    area.removeFromTop(4);
+
+    // Load histogram, log-scaled counts; the last (red) bin is over budget
+    juce::int64 maxCount = 1;
+    for (auto count : stats.histogram)
+        maxCount = juce::jmax(maxCount, count);
+
+    const auto labels = area.removeFromBottom(12);
+    const int binWidth = area.getWidth() / CpuMeter::numBins;
+    g.setFont(10.0f);
+    for (int bin = 0; bin < CpuMeter::numBins; ++bin)
+    {
+        const auto column = area.withX(area.getX() + bin * binWidth).withWidth(binWidth).reduced(2, 0);
+        const float fraction = static_cast<float>(std::log1p(static_cast<double>(stats.histogram[bin])) / std::log1p(static_cast<double>(maxCount)));
+        g.setColour(bin == CpuMeter::overBudgetBin ? juce::Colours::red : juce::Colours::skyblue);
+        g.fillRect(column.withTop(column.getBottom() - juce::roundToInt(fraction * static_cast<float>(column.getHeight()))));
+
+        const auto label = bin == CpuMeter::overBudgetBin ? juce::String(">100%") : juce::String(CpuMeter::getBinUpperLoad(bin) * 100.0, 1) + "%";
+        g.setColour(juce::Colours::white.withAlpha(0.7f));
+        g.drawText(label, column.withY(labels.getY()).withHeight(labels.getHeight()), juce::Justification::centred);
+    }
 }
 
 void DelayFilterPluginAudioProcessorEditor::resized()
 {
     auto area = getLocalBounds().reduced(12);
     auto topArea = area.removeFromTop(40);
-    filterChoice.setBounds(topArea.removeFromLeft(150).reduced(8));
-    iirTypeChoice.setBounds(topArea.removeFromRight(150).reduced(8));
+    filterChoice.setBounds(topArea.removeFromLeft(140).reduced(8));
+    iirTypeChoice.setBounds(topArea.removeFromRight(140).reduced(8));
+    iirSlopeChoice.setBounds(topArea.removeFromRight(140).reduced(8));
+    lfoShapeChoice.setBounds(topArea.removeFromRight(140).reduced(8));
+
+    responseView.setBounds(area.removeFromTop(160).reduced(4, 0));
 
     auto row1 = area.removeFromTop(140);
-    int nSlidersRow1 = 5;
+    int nSlidersRow1 = 6;
     int colW1 = row1.getWidth() / nSlidersRow1;
     mixSlider.setBounds(row1.removeFromLeft(colW1).reduced(5));
     delayMsSlider.setBounds(row1.removeFromLeft(colW1).reduced(5));
     feedbackSlider.setBounds(row1.removeFromLeft(colW1).reduced(5));
     tapsSlider.setBounds(row1.removeFromLeft(colW1).reduced(5));
     tapGainSlider.setBounds(row1.removeFromLeft(colW1).reduced(5));
+    phaserSpreadSlider.setBounds(row1.removeFromLeft(colW1).reduced(5));
 
     auto row2 = area.removeFromTop(140);
-    int nSlidersRow2 = 4;
+    int nSlidersRow2 = 6;
     int colW2 = row2.getWidth() / nSlidersRow2;
     filterFreqSlider.setBounds(row2.removeFromLeft(colW2).reduced(5));
     iirQSlider.setBounds(row2.removeFromLeft(colW2).reduced(5));
     lfoRateSlider.setBounds(row2.removeFromLeft(colW2).reduced(5));
     lfoDepthSlider.setBounds(row2.removeFromLeft(colW2).reduced(5));
+    lfoStereoSlider.setBounds(row2.removeFromLeft(colW2).reduced(5));
+    phaserFeedbackSlider.setBounds(row2.removeFromLeft(colW2).reduced(5));
+
+    auto bottomArea = area.removeFromTop(40);
+    oversamplingChoice.setBounds(bottomArea.removeFromLeft(140).reduced(8));
+    offlineOversamplingChoice.setBounds(bottomArea.removeFromLeft(180).reduced(8));
+    delayStorageChoice.setBounds(bottomArea.removeFromLeft(190).reduced(8));
+
+    auto chainArea = area.removeFromTop(40);
+    routingChoice.setBounds(chainArea.removeFromLeft(140).reduced(8));
+    const int slotWidth = chainArea.getWidth() / 4;
+    for (auto& choice : chainStageChoices)
+        choice.setBounds(chainArea.removeFromLeft(slotWidth).reduced(8));
+
+    auto presetArea = area.removeFromTop(40);
+    presetChoice.setBounds(presetArea.removeFromLeft(240).reduced(8));
+    savePresetButton.setBounds(presetArea.removeFromLeft(130).reduced(8));
+    phaserStagesChoice.setBounds(presetArea.removeFromRight(170).reduced(8));
+
+    if (CpuMeter::enabled)
+    {
+        auto meterArea = area.removeFromTop(100);
+        auto buttons = meterArea.removeFromRight(150);
+        dumpCpuStatsButton.setBounds(buttons.removeFromTop(40).reduced(8));
+        resetCpuStatsButton.setBounds(buttons.removeFromTop(40).reduced(8));
+        cpuMeterArea = meterArea.reduced(4);
+    }
 }
\ No newline at end of file
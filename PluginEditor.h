@@ -2,8 +2,10 @@
 #pragma once
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "ResponseView.h"
 
-class DelayFilterPluginAudioProcessorEditor : public juce::AudioProcessorEditor
+class DelayFilterPluginAudioProcessorEditor : public juce::AudioProcessorEditor,
+                                              private juce::Timer
 {
 public:
     DelayFilterPluginAudioProcessorEditor(DelayFilterPluginAudioProcessor&);
@@ -15,13 +17,40 @@ public:
 private:
     DelayFilterPluginAudioProcessor& audioProcessor;
 
+    // Response curve of the current settings, with the optional output spectrum
+    ResponseView responseView{ audioProcessor };
+
     // GUI components bound to parameters
-    juce::ComboBox filterChoice, iirTypeChoice;
-    juce::Slider mixSlider, delayMsSlider, feedbackSlider, tapsSlider, tapGainSlider, filterFreqSlider, iirQSlider, lfoRateSlider, lfoDepthSlider;
+    juce::ComboBox filterChoice, iirTypeChoice, iirSlopeChoice, lfoShapeChoice, oversamplingChoice, offlineOversamplingChoice, delayStorageChoice,
+                   phaserStagesChoice;
+    // Routing: single mode, or the chain slots in series
+    juce::ComboBox routingChoice;
+    juce::ComboBox chainStageChoices[4];
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> routingAttachment, chainStageAttachments[4];
+
+    // Preset bank: factory presets, then user presets
+    juce::ComboBox presetChoice;
+    juce::TextButton savePresetButton{ "Save preset..." };
+    void refreshPresetList();
+    void savePreset();
+
+    // CPU meter: load bar, per-mode cost and load histogram, repainted at 10 Hz
+    juce::TextButton dumpCpuStatsButton{ "Dump CPU stats..." }, resetCpuStatsButton{ "Reset" };
+    std::unique_ptr<juce::FileChooser> cpuStatsChooser;
+    juce::Rectangle<int> cpuMeterArea;
+    void timerCallback() override;
+    void paintCpuMeter(juce::Graphics&);
+    void dumpCpuStats();
+
+    juce::Slider mixSlider, delayMsSlider, feedbackSlider, tapsSlider, tapGainSlider, filterFreqSlider, iirQSlider, lfoRateSlider, lfoDepthSlider, lfoStereoSlider,
+                 phaserSpreadSlider, phaserFeedbackSlider;
 
     using Attachment = juce::AudioProcessorValueTreeState::SliderAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> filterChoiceAttachment, iirTypeAttachment;
-    std::unique_ptr<Attachment> mixAttachment, delayMsAttachment, feedbackAttachment, tapsAttachment, tapGainAttachment, filterFreqAttachment, iirQAttachment, lfoRateAttachment, lfoDepthAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> filterChoiceAttachment, iirTypeAttachment, iirSlopeAttachment, lfoShapeAttachment,
+                                                                                    oversamplingAttachment, offlineOversamplingAttachment, delayStorageAttachment,
+                                                                                    phaserStagesAttachment;
+    std::unique_ptr<Attachment> mixAttachment, delayMsAttachment, feedbackAttachment, tapsAttachment, tapGainAttachment, filterFreqAttachment, iirQAttachment, lfoRateAttachment, lfoDepthAttachment, lfoStereoAttachment,
+                                 phaserSpreadAttachment, phaserFeedbackAttachment;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DelayFilterPluginAudioProcessorEditor)
 };
\ No newline at end of file
@@ -1,16 +1,103 @@
 // === File: PluginProcessor.cpp ===
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "RealtimeGuard.h"
 #include <cmath>
 
+namespace
+{
+    // The smoothers render float ramps; the double path widens the ones it multiplies into audio
+    template <typename SampleType>
+    const SampleType* widenRamp(const float* ramp, juce::AudioBuffer<SampleType>& scratch, int row, int numSamples) noexcept
+    {
+        if constexpr (std::is_same_v<SampleType, float>)
+        {
+            return ramp;
+        }
+        else
+        {
+            SampleType* dest = scratch.getWritePointer(row);
+            std::copy_n(ramp, numSamples, dest);
+            return dest;
+        }
+    }
+
+    template <typename SampleType>
+    SampleType getPeak(SampleType* const* channels, int numChannels, int numSamples) noexcept
+    {
+        SampleType peak = 0;
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const auto range = juce::FloatVectorOperations::findMinAndMax(channels[ch], numSamples);
+            peak = juce::jmax(peak, -range.getStart(), range.getEnd());
+        }
+        return peak;
+    }
+}
+
 DelayFilterPluginAudioProcessor::DelayFilterPluginAudioProcessor()
     : AudioProcessor(BusesProperties().withInput("Input", juce::AudioChannelSet::stereo(), true)
         .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
     apvts(*this, nullptr, "Parameters", createParameters())
 {
+    filterTypeParam = apvts.getRawParameterValue("filterType");
+    mixParam = apvts.getRawParameterValue("mix");
+    delayMsParam = apvts.getRawParameterValue("delayMs");
+    feedbackParam = apvts.getRawParameterValue("feedback");
+    tapsParam = apvts.getRawParameterValue("taps");
+    tapGainParam = apvts.getRawParameterValue("tapGain");
+    lfoRateParam = apvts.getRawParameterValue("lfoRate");
+    lfoDepthParam = apvts.getRawParameterValue("lfoDepth");
+    lfoShapeParam = apvts.getRawParameterValue("lfoShape");
+    lfoStereoParam = apvts.getRawParameterValue("lfoStereo");
+    iirTypeParam = apvts.getRawParameterValue("iirType");
+    filterFreqParam = apvts.getRawParameterValue("filterFreq");
+    iirQParam = apvts.getRawParameterValue("iirQ");
+    iirSlopeParam = apvts.getRawParameterValue("iirSlope");
+    oversamplingParam = apvts.getRawParameterValue("oversampling");
+    offlineOversamplingParam = apvts.getRawParameterValue("offlineOversampling");
+    delayStorageParam = apvts.getRawParameterValue("delayStorage");
+    phaserStagesParam = apvts.getRawParameterValue("phaserStages");
+    phaserSpreadParam = apvts.getRawParameterValue("phaserSpread");
+    phaserFeedbackParam = apvts.getRawParameterValue("phaserFeedback");
+    routingParam = apvts.getRawParameterValue("routing");
+    for (int slot = 0; slot < maxChainStages; ++slot)
+        chainStageParams[slot] = apvts.getRawParameterValue("chainStage" + juce::String(slot + 1));
+
+    mixSmoothed.attach(mixParam);
+    delayMsSmoothed.attach(delayMsParam);
+    feedbackSmoothed.attach(feedbackParam);
+    tapGainSmoothed.attach(tapGainParam);
+    filterFreqSmoothed.attach(filterFreqParam);
+    iirQSmoothed.attach(iirQParam);
+    lfoRateSmoothed.attach(lfoRateParam);
+    lfoDepthSmoothed.attach(lfoDepthParam);
+    lfoStereoSmoothed.attach(lfoStereoParam);
+    phaserSpreadSmoothed.attach(phaserSpreadParam);
+    phaserFeedbackSmoothed.attach(phaserFeedbackParam);
+
+    startTimerHz(10);
 }
 
-DelayFilterPluginAudioProcessor::~DelayFilterPluginAudioProcessor() = default;
+DelayFilterPluginAudioProcessor::~DelayFilterPluginAudioProcessor()
+{
+    stopTimer();
+}
+
+void DelayFilterPluginAudioProcessor::timerCallback()
+{
+    const int latency = pendingLatencySamples.load(std::memory_order_relaxed);
+    if (latency != getLatencySamples())
+        setLatencySamples(latency);
+
+    buildSpareDelayLine(floatState);
+    buildSpareDelayLine(doubleState);
+    buildSpareOversampledPath(floatState);
+    buildSpareOversampledPath(doubleState);
+    firEngine.buildSparePartitions(getRequiredFirPartitions());
+
+    cpuMeter.collect();
+}
 
 juce::AudioProcessorValueTreeState::ParameterLayout DelayFilterPluginAudioProcessor::createParameters()
 {
@@ -25,7 +112,7 @@ juce::AudioProcessorValueTreeState::ParameterLayout DelayFilterPluginAudioProces
     // Delay / comb / flanger
     params.push_back(std::make_unique<juce::AudioParameterFloat>("delayMs", "Delay (ms)", juce::NormalisableRange<float>(0.1f, 1000.0f), 20.0f));
     params.push_back(std::make_unique<juce::AudioParameterFloat>("feedback", "Feedback", juce::NormalisableRange<float>(-0.99f, 0.99f), 0.0f));
-    params.push_back(std::make_unique<juce::AudioParameterFloat>("taps", "Taps", juce::NormalisableRange<float>(1.0f, 16.0f, 1.0f), 2.0f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("taps", "Taps", juce::NormalisableRange<float>(1.0f, static_cast<float>(FirEngine::maxTaps), 1.0f, 0.3f), 2.0f));
 
     // FIR specific: windowed gain control for taps (single master for simplicity)
     params.push_back(std::make_unique<juce::AudioParameterFloat>("tapGain", "Tap Gain", juce::NormalisableRange<float>(0.0f, 1.0f), 0.5f));
@@ -37,48 +124,206 @@ juce::AudioProcessorValueTreeState::ParameterLayout DelayFilterPluginAudioProces
     params.push_back(std::make_unique<juce::AudioParameterFloat>("iirQ", "IIR Q", juce::NormalisableRange<float>(0.1f, 20.0f), 0.707f));
     params.push_back(std::make_unique<juce::AudioParameterChoice>("iirType", "IIR Type",
         juce::StringArray{ "Low-pass", "High-pass", "Band-pass" }, 0));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("iirSlope", "IIR Slope",
+        juce::StringArray{ "12 dB/oct", "24 dB/oct" }, 0));
 
     // Phaser / flanger LFO
     params.push_back(std::make_unique<juce::AudioParameterFloat>("lfoRate", "LFO Rate Hz", juce::NormalisableRange<float>(0.01f, 10.0f), 0.5f));
     params.push_back(std::make_unique<juce::AudioParameterFloat>("lfoDepth", "LFO Depth ms", juce::NormalisableRange<float>(0.0f, 10.0f), 2.0f));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("lfoShape", "LFO Shape",
+        juce::StringArray{ "Sine", "Triangle", "S&H" }, 0));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("lfoStereo", "LFO Stereo Phase", juce::NormalisableRange<float>(0.0f, 180.0f), 0.0f));
+
+    // Phaser: allpass count, spread of the stage centres around Filter Freq, and feedback
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("phaserStages", "Phaser Stages",
+        juce::StringArray{ "2", "4", "8", "12" }, 0));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("phaserSpread", "Phaser Spread", juce::NormalisableRange<float>(0.0f, 1.0f), 0.0f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("phaserFeedback", "Phaser Feedback", juce::NormalisableRange<float>(-0.9f, 0.9f), 0.0f));
+
+    // Routing: the Filter Type alone, or the chain slots in series (at the host rate; a mode
+    // repeated in a later slot is skipped)
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("routing", "Routing",
+        juce::StringArray{ "Single", "Chain" }, 0));
+    const int defaultChain[maxChainStages] = { 1, 3, 5, 0 }; // Comb -> IIR -> Flanger
+    for (int slot = 0; slot < maxChainStages; ++slot)
+        params.push_back(std::make_unique<juce::AudioParameterChoice>("chainStage" + juce::String(slot + 1), "Chain Stage " + juce::String(slot + 1),
+            juce::StringArray{ "Off", "Comb", "FIR", "IIR", "Phaser", "Flanger" }, defaultChain[slot]));
+
+    // Oversampling for comb / phaser / flanger; offline renders may use a higher factor
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("oversampling", "Oversampling",
+        juce::StringArray{ "1x", "2x", "4x", "8x" }, 0));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("offlineOversampling", "Offline Oversampling",
+        juce::StringArray{ "Same as realtime", "1x", "2x", "4x", "8x" }, 0));
+
+    // Comb / FIR / flanger delay storage: compact halves the memory traffic of long delays
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("delayStorage", "Delay Storage",
+        juce::StringArray{ "Full precision", "Compact 16-bit" }, 0));
 
     return { params.begin(), params.end() };
 }
 
 void DelayFilterPluginAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
-    (void)samplesPerBlock;
     currentSampleRate = sampleRate;
-    int maxDelaySamples = static_cast<int>(sampleRate * 2.0); // 2 seconds max
-    delayBuffer.setSize(2, maxDelaySamples);
-    delayBuffer.clear();
-    writePosition = 0;
-    lfoPhase = 0.0;
+    maxBlockSize = juce::jmax(1, samplesPerBlock);
+    numChannels = juce::jlimit(1, maxChannels, getMainBusNumOutputChannels());
+    const int oversampledBlockSize = maxBlockSize << maxOversamplingOrder;
+    lfoBuffer.setSize(numChannels, oversampledBlockSize);
+    modBuffer.setSize(numChannels, oversampledBlockSize);
+    oversampledRamps.setSize(3, oversampledBlockSize);
+
+    firEngine.prepare(sampleRate, numChannels, maxFirSpanSeconds, getRequiredFirPartitions());
+    lfo.prepare(sampleRate);
+    lfo.setControlInterval(lfoControlInterval);
+    cpuMeter.prepare(sampleRate, maxBlockSize);
+    spectrumFeed.prepare(sampleRate);
+
+    // Only the precision the host will call with holds audio state
+    if (isUsingDoublePrecision())
+    {
+        prepareEngineState(doubleState);
+        floatState = {};
+    }
+    else
+    {
+        prepareEngineState(floatState);
+        doubleState = {};
+    }
+
+    // Report the FFT-path or oversampling latency up front if the session opens in that state
+    pendingLatencySamples = getLatencyForChain(getModeChain());
+    setLatencySamples(pendingLatencySamples.load());
+
+    silentSamples = 0;
+    idle = false;
 
-    juce::dsp::ProcessSpec spec{ static_cast<float>(sampleRate), static_cast<juce::uint32>(1), static_cast<juce::uint32>(samplesPerBlock) };
-    for (auto& f : iirFilter)
-        f.prepare(spec);
+    for (auto* smoothed : getSmoothedParameters())
+        smoothed->prepare(sampleRate, 0.05, maxBlockSize);
+}
+
+template <typename SampleType>
+void DelayFilterPluginAudioProcessor::prepareEngineState(EngineState<SampleType>& state)
+{
+    const int oversampledBlockSize = maxBlockSize << maxOversamplingOrder;
+    state.maxBlockSize = maxBlockSize;
+    state.dryBuffer.setSize(numChannels, maxBlockSize);
+    state.dryBuffer.clear();
+    state.wetBuffer.setSize(numChannels, oversampledBlockSize);
+    state.wetBuffer.clear();
+    state.rampBuffer.setSize(2, oversampledBlockSize);
+    state.tapFadeBuffer.setSize(2, oversampledBlockSize);
+
+    // Sized for what the current settings reach; timerCallback grows it when they need more
+    const int requiredDelay = getRequiredDelaySamples();
+    state.delayLine.prepare(numChannels, requiredDelay, maxBlockSize, getDelayStorage());
+    state.spareDelayLine.reset();
+    state.pendingHistory = -1;
+    delayLineHandover = handoverIdle;
+    requiredDelaySamples = requiredDelay;
+    activeMaxDelaySamples = state.delayLine.getMaxDelaySamples();
+    activeDelayStorage = static_cast<int>(state.delayLine.getStorage());
+    const int combDelaySamples = static_cast<int>(std::ceil(maxCombDelayMs * 0.001 * currentSampleRate)) + 1;
+    state.combEngine.prepare(numChannels, combDelaySamples);
+    state.flangerEngine.prepare(numChannels, combDelaySamples);
+    state.combTap.prepare(currentSampleRate);
+
+    state.iirEngine.prepare(currentSampleRate, numChannels, maxBlockSize);
+
+    // Latency of every factor for both qualities, known before that path is built; integer
+    // latency keeps the dry path a plain delay. The filter designs are discarded again.
+    int maxOversamplingLatency = 0;
+    for (int quality = 0; quality < 2; ++quality)
+    {
+        for (int order = 1; order <= maxOversamplingOrder; ++order)
+        {
+            using Oversampling = juce::dsp::Oversampling<SampleType>;
+            const auto filterType = quality == 0 ? Oversampling::filterHalfBandPolyphaseIIR : Oversampling::filterHalfBandFIREquiripple;
+            const Oversampling oversampler(static_cast<size_t>(numChannels), static_cast<size_t>(order), filterType, quality == 1, true);
+            oversamplingLatencies[quality][order - 1] = juce::roundToInt(oversampler.getLatencyInSamples());
+            maxOversamplingLatency = juce::jmax(maxOversamplingLatency, oversamplingLatencies[quality][order - 1]);
+        }
+    }
 
-    smoothFilterFreq.reset(static_cast<float>(sampleRate), 0.05f);
-    smoothQ.reset(static_cast<float>(sampleRate), 0.05f);
+    // Only the current factor is built; timerCallback builds another when the settings change
+    const int oversamplingKey = getOversamplingKey();
+    state.oversampledPath = oversamplingKey >= 0 ? makeOversampledPath<SampleType>(oversamplingKey) : nullptr;
+    state.spareOversampledPath.reset();
+    oversamplingHandover = handoverIdle;
+    activeOversamplingKey = oversamplingKey;
+    state.dryDelayLine.prepare(numChannels, juce::jmax(maxOversamplingLatency, FirEngine::partitionSize), maxBlockSize);
 
-    std::fill(std::begin(ap_x1), std::end(ap_x1), 0.0f);
-    std::fill(std::begin(ap_y1), std::end(ap_y1), 0.0f);
-    std::fill(std::begin(ap_x2), std::end(ap_x2), 0.0f);
-    std::fill(std::begin(ap_y2), std::end(ap_y2), 0.0f);
+    state.phaserEngine.prepare(numChannels);
 }
 
 void DelayFilterPluginAudioProcessor::releaseResources() {}
 
+double DelayFilterPluginAudioProcessor::getTailLengthSeconds() const
+{
+    // Time for the output to fall below silenceThreshold once the input stops, plus the latency.
+    // Chained stages ring one after the other, so their tails add up.
+    const auto chain = getModeChain();
+    double seconds = 0.0;
+    for (int i = 0; i < chain.numStages; ++i)
+        seconds += getModeTailSeconds(chain.stages[i], silenceThreshold);
+
+    return seconds + getLatencySamples() / currentSampleRate;
+}
+
+double DelayFilterPluginAudioProcessor::getModeTailSeconds(FilterMode mode, double level) const
+{
+    const double freq = juce::jmax(20.0, static_cast<double>(filterFreqParam->load()));
+    double seconds = 0.0;
+
+    switch (mode)
+    {
+    case FilterMode::comb:
+    case FilterMode::flanger:
+    {
+        // Each trip round the feedback loop takes one delay period and scales the level by |feedback|
+        const double periodSeconds = 1.0 / freq + (mode == FilterMode::flanger ? 0.001 * lfoDepthParam->load() : 0.0);
+        const double feedback = std::abs(static_cast<double>(feedbackParam->load()));
+        const double trips = feedback > level ? std::ceil(std::log(level) / std::log(feedback)) : 1.0;
+        seconds = periodSeconds * trips;
+        break;
+    }
+    case FilterMode::fir:
+        seconds = juce::jmin(maxFirSpanSeconds, juce::jmax(0.0, tapsParam->load() - 1.0) / freq);
+        break;
+    case FilterMode::iir:
+        seconds = StateVariableFilter<float>::getDecaySeconds(freq, iirQParam->load(), static_cast<int>(iirSlopeParam->load()) + 1, level);
+        break;
+    case FilterMode::phaser:
+        seconds = PhaserEngine<float>::getDecaySamples(getPhaserStages(), phaserFeedbackParam->load(), level) / currentSampleRate;
+        break;
+    }
+
+    return seconds;
+}
+
 bool DelayFilterPluginAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
 {
-    if (layouts.getMainInputChannelSet() != juce::AudioChannelSet::stereo()) return false;
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo()) return false;
-    return true;
+    // Any layout from mono up to maxChannels (surround, discrete or ambisonic), same in and out
+    const auto& in = layouts.getMainInputChannelSet();
+    const auto& out = layouts.getMainOutputChannelSet();
+    if (out.isDisabled() || in != out) return false;
+    return out.size() >= 1 && out.size() <= maxChannels;
 }
 
 void DelayFilterPluginAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
 {
+    processBlockInternal(buffer);
+}
+
+void DelayFilterPluginAudioProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer&)
+{
+    processBlockInternal(buffer);
+}
+
+template <typename SampleType>
+void DelayFilterPluginAudioProcessor::processBlockInternal(juce::AudioBuffer<SampleType>& buffer)
+{
+    RealtimeGuard::ScopedRealtimeSection realtimeSection;
+    CpuMeter::ScopedBlock cpuBlock(cpuMeter, buffer.getNumSamples());
     juce::ScopedNoDenormals noDenormals;
     auto totalNumInputChannels = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -86,275 +331,774 @@ void DelayFilterPluginAudioProcessor::processBlock(juce::AudioBuffer<float>& buf
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, buffer.getNumSamples());
 
-    // Read parameter values (atomic-safe snapshot)
-    int filterType = static_cast<int>(*apvts.getRawParameterValue("filterType"));
-    float mix = *apvts.getRawParameterValue("mix");
-    float delayMs = *apvts.getRawParameterValue("delayMs");
-    float feedback = *apvts.getRawParameterValue("feedback");
-    int taps = static_cast<int>(*apvts.getRawParameterValue("taps"));
-    float tapGain = *apvts.getRawParameterValue("tapGain");
-    float lfoRate = *apvts.getRawParameterValue("lfoRate");
-    float lfoDepthMs = *apvts.getRawParameterValue("lfoDepth");
-    int iirType = static_cast<int>(*apvts.getRawParameterValue("iirType"));
-    float filterFreq = *apvts.getRawParameterValue("filterFreq");
-    float iirQ = *apvts.getRawParameterValue("iirQ");
+    auto& state = getEngineState<SampleType>();
+    jassert(state.maxBlockSize > 0); // prepareToPlay must run first, in this precision
+    if (state.maxBlockSize <= 0)
+        return;
+
+    swapInSpareDelayLine(state, buffer.getNumSamples());
+    swapInSpareOversampledPath(state);
+    firEngine.swapInSparePartitions();
 
+    // Hosts may exceed the block size given to prepareToPlay; split rather than reallocate
     const int numSamples = buffer.getNumSamples();
-    const int maxDelaySamples = delayBuffer.getNumSamples();
-    const int numCh = 2;
-    float maxDelaySamplesF = static_cast<float>(maxDelaySamples);
+    bool ranKernels = false;
+    for (int start = 0; start < numSamples; start += maxBlockSize)
+        ranKernels = processSubBlock(state, buffer, start, juce::jmin(maxBlockSize, numSamples - start)) || ranKernels;
+
+    spectrumFeed.push(buffer.getArrayOfReadPointers(), numChannels, numSamples);
+
+    if (! ranKernels)
+        cpuBlock.setCategory(CpuMeter::idleCategory);
+    else if (const auto chain = getModeChain(); chain.chained)
+        cpuBlock.setCategory(CpuMeter::chainCategory);
+    else
+        cpuBlock.setCategory(static_cast<int>(chain.stages[0]));
+}
+
+std::array<SmoothedParameter*, 11> DelayFilterPluginAudioProcessor::getSmoothedParameters() noexcept
+{
+    return { &mixSmoothed, &delayMsSmoothed, &feedbackSmoothed, &tapGainSmoothed, &filterFreqSmoothed,
+             &iirQSmoothed, &lfoRateSmoothed, &lfoDepthSmoothed, &lfoStereoSmoothed, &phaserSpreadSmoothed,
+             &phaserFeedbackSmoothed };
+}
+
+int DelayFilterPluginAudioProcessor::getPhaserStages() const noexcept
+{
+    return phaserStageCounts[juce::jlimit(0, 3, static_cast<int>(phaserStagesParam->load()))];
+}
+
+DelayFilterPluginAudioProcessor::BlockParams DelayFilterPluginAudioProcessor::readBlockParams(int numSamples)
+{
+    // Discrete parameters: atomic-safe snapshot
+    BlockParams p;
+    p.chain = getModeChain();
+    p.mode = p.chain.numStages > 0 ? p.chain.stages[0] : FilterMode::comb;
+    p.taps = juce::jmax(1, static_cast<int>(tapsParam->load()));
+    p.lfoShape = static_cast<int>(lfoShapeParam->load());
+    p.iirType = static_cast<int>(iirTypeParam->load());
+    p.iirSlope = static_cast<int>(iirSlopeParam->load());
+    p.phaserStages = getPhaserStages();
+    p.oversamplingOrder = p.chain.chained ? 0 : getOversamplingOrder(p.mode);
+    p.sampleRate = currentSampleRate;
+
+    // Continuous parameters: advance every smoother so none of them jump on a mode switch
+    for (auto* smoothed : getSmoothedParameters())
+        smoothed->process(numSamples);
+
+    p.mix = mixSmoothed.getCurrentValue();
+    p.delayMs = delayMsSmoothed.getCurrentValue();
+    p.feedback = feedbackSmoothed.getCurrentValue();
+    p.tapGain = tapGainSmoothed.getCurrentValue();
+    p.filterFreq = filterFreqSmoothed.getCurrentValue();
+    p.iirQ = iirQSmoothed.getCurrentValue();
+    p.lfoRate = lfoRateSmoothed.getCurrentValue();
+    p.lfoDepthMs = lfoDepthSmoothed.getCurrentValue();
+    p.lfoStereoDegrees = lfoStereoSmoothed.getCurrentValue();
+    p.phaserSpread = phaserSpreadSmoothed.getCurrentValue();
+    p.phaserFeedback = phaserFeedbackSmoothed.getCurrentValue();
 
+    p.mixRamp = mixSmoothed.getRamp();
+    p.feedbackRamp = feedbackSmoothed.getRamp();
+    p.filterFreqRamp = filterFreqSmoothed.getRamp();
+    p.iirQRamp = iirQSmoothed.getRamp();
+    p.lfoDepthRamp = lfoDepthSmoothed.getRamp();
+    p.mixSmoothing = mixSmoothed.isSmoothing();
+    p.feedbackSmoothing = feedbackSmoothed.isSmoothing();
+    p.filterFreqSmoothing = filterFreqSmoothed.isSmoothing();
+
+    p.effectiveDelayMs = getEffectiveDelayMs(p);
+    return p;
+}
+
+float DelayFilterPluginAudioProcessor::getEffectiveDelayMs(const BlockParams& p) noexcept
+{
     // Compute effective delay based on filterFreq for non-IIR modes
-    float effectiveDelayMs = delayMs;
-    if (filterFreq > 0.0f && (filterType == 0 || filterType == 1 || filterType == 4))
+    float delayMs = p.delayMs;
+    if (p.filterFreq > 0.0f && (p.mode == FilterMode::comb || p.mode == FilterMode::fir || p.mode == FilterMode::flanger))
+        delayMs = 1000.0f / p.filterFreq;
+
+    // For FIR, adjust span to have tap spacing corresponding to filterFreq
+    if (p.mode == FilterMode::fir && p.taps > 1)
+        delayMs = (1000.0f / p.filterFreq) * static_cast<float>(p.taps - 1);
+
+    return delayMs;
+}
+
+DelayFilterPluginAudioProcessor::ModeChain DelayFilterPluginAudioProcessor::getModeChain() const noexcept
+{
+    ModeChain chain;
+    if (static_cast<int>(routingParam->load()) == 0)
     {
-        float targetDelaySamples = static_cast<float>(currentSampleRate) / filterFreq;
-        effectiveDelayMs = (targetDelaySamples / static_cast<float>(currentSampleRate)) * 1000.0f;
+        chain.stages[0] = static_cast<FilterMode>(juce::jlimit(0, 4, static_cast<int>(filterTypeParam->load())));
+        chain.numStages = 1;
+        return chain;
     }
-    if (filterType == 1)
+
+    chain.chained = true;
+    for (auto* slot : chainStageParams)
     {
-        // For FIR, adjust span to have tap spacing corresponding to filterFreq
-        if (taps > 1)
-            effectiveDelayMs = (1000.0f / filterFreq) * static_cast<float>(taps - 1);
+        const int choice = juce::jlimit(0, 5, static_cast<int>(slot->load()));
+        if (choice > 0 && ! chain.contains(static_cast<FilterMode>(choice - 1)))
+            chain.stages[chain.numStages++] = static_cast<FilterMode>(choice - 1);
     }
+    return chain;
+}
+
+FilterResponse::Settings DelayFilterPluginAudioProcessor::getResponseSettings() const
+{
+    // Target values rather than the smoothed ones: the curve shows where a sweep is heading
+    FilterResponse::Settings s;
+    const auto chain = getModeChain();
+    s.numModes = chain.numStages;
+    for (int i = 0; i < chain.numStages; ++i)
+        s.modes[i] = static_cast<int>(chain.stages[i]);
+    s.sampleRate = currentSampleRate;
+    s.oversamplingFactor = chain.chained || chain.numStages == 0 ? 1 : 1 << getOversamplingOrder(chain.stages[0]);
+    s.mix = mixParam->load();
+    s.feedback = feedbackParam->load();
+    s.filterFreq = filterFreqParam->load();
+
+    s.tapGain = tapGainParam->load();
+    s.tapSpacingSamples = static_cast<float>(currentSampleRate) / s.filterFreq;
+    s.taps = juce::jmin(juce::jmax(1, static_cast<int>(tapsParam->load())),
+                        1 + static_cast<int>(maxFirSpanSeconds * currentSampleRate / s.tapSpacingSamples));
+
+    s.iirType = static_cast<int>(iirTypeParam->load());
+    s.iirStages = static_cast<int>(iirSlopeParam->load()) + 1;
+    s.iirQ = iirQParam->load();
+
+    s.phaserStages = getPhaserStages();
+    s.phaserSpread = phaserSpreadParam->load();
+    s.phaserFeedback = phaserFeedbackParam->load();
+    s.lfoDepthMs = lfoDepthParam->load();
+    s.lfoValue = lfoDisplayValue.load(std::memory_order_relaxed);
+    return s;
+}
+
+int DelayFilterPluginAudioProcessor::getLatencyForMode(FilterMode mode) const noexcept
+{
+    if (mode == FilterMode::fir)
+        return FirEngine::getLatencyForTaps(static_cast<int>(tapsParam->load()));
+    if (const int order = getOversamplingOrder(mode); order > 0)
+        return oversamplingLatencies[isNonRealtime() ? 1 : 0][order - 1];
+    return 0;
+}
+
+int DelayFilterPluginAudioProcessor::getLatencyForChain(const ModeChain& chain) const noexcept
+{
+    // Chains don't oversample, so only an FFT-path FIR stage adds latency there
+    if (! chain.chained)
+        return chain.numStages > 0 ? getLatencyForMode(chain.stages[0]) : 0;
+    return chain.contains(FilterMode::fir) ? getLatencyForMode(FilterMode::fir) : 0;
+}
+
+template <typename SampleType>
+bool DelayFilterPluginAudioProcessor::processSubBlock(EngineState<SampleType>& state, juce::AudioBuffer<SampleType>& buffer, int startSample, int numSamples)
+{
+    const int numCh = numChannels;
+
+    SampleType* channels[maxChannels];
+    for (int ch = 0; ch < numCh; ++ch)
+        channels[ch] = buffer.getWritePointer(ch, startSample);
 
-    // Handle IIR separately with block processing
-    juce::AudioBuffer<float> dryBuffer(numCh, numSamples);
-    bool isIIR = (filterType == 2);
-    if (isIIR)
+    // Idle blocks pass the (silent) input straight through. The state left behind is below the
+    // threshold too, so the kernels pick up from it without a click when signal returns.
+    const bool inputSilent = getPeak(channels, numCh, numSamples) < static_cast<SampleType>(silenceThreshold);
+    if (idle && inputSilent)
     {
-        dryBuffer.makeCopyOf(buffer);
+        processIdle(numSamples);
+        return false;
+    }
+    idle = false;
 
-        // Smooth and update coefficients
-        smoothFilterFreq.setTargetValue(filterFreq);
-        smoothQ.setTargetValue(iirQ);
-        float cutoff = smoothFilterFreq.getNextValue();
-        float qVal = smoothQ.getNextValue();
+    const BlockParams p = readBlockParams(numSamples);
+    for (int ch = 0; ch < numCh; ++ch)
+        state.dryBuffer.copyFrom(ch, 0, channels[ch], numSamples);
 
-        switch (iirType)
+    // Mode is chosen once per block; each kernel writes the wet signal in place. A factor whose
+    // oversampled path timerCallback hasn't handed over yet runs at the host rate meanwhile.
+    const bool oversampled = p.oversamplingOrder > 0 && state.oversampledPath != nullptr
+                             && state.oversampledPath->key == getOversamplingKey(p.oversamplingOrder);
+    int latency = 0;
+    lfoRendered = false;
+    if (p.chain.chained)
+    {
+        latency = processChain(state, channels, p, numSamples);
+    }
+    else if (oversampled)
+    {
+        latency = processOversampled(state, channels, p, numSamples);
+    }
+    else
+    {
+        switch (p.mode)
         {
-        case 0: iirCoeffs = juce::dsp::IIR::Coefficients<float>::makeLowPass(currentSampleRate, cutoff, qVal); break;
-        case 1: iirCoeffs = juce::dsp::IIR::Coefficients<float>::makeHighPass(currentSampleRate, cutoff, qVal); break;
-        case 2: iirCoeffs = juce::dsp::IIR::Coefficients<float>::makeBandPass(currentSampleRate, cutoff, qVal); break;
-        default: iirCoeffs = juce::dsp::IIR::Coefficients<float>::makeLowPass(currentSampleRate, cutoff, qVal); break;
+        case FilterMode::comb:    processCombKernel<SampleType, false>(state, channels, p, state.combEngine, state.combTap, numSamples); break;
+        case FilterMode::fir:     processFirKernel(state, channels, p, numSamples); break;
+        case FilterMode::iir:     processIirKernel(state, channels, p, numSamples); break;
+        case FilterMode::phaser:  processPhaserKernel(state, channels, p, numSamples); break;
+        case FilterMode::flanger: processCombKernel<SampleType, true>(state, channels, p, state.combEngine, state.combTap, numSamples); break;
         }
-        if (iirCoeffs != nullptr)
+
+        if (p.mode == FilterMode::fir)
+            latency = firEngine.getLatencySamples();
+    }
+
+    // Anything still held in the delay line or filter state shows up in the wet output
+    const bool wetSilent = inputSilent && getPeak(channels, numCh, numSamples) < static_cast<SampleType>(silenceThreshold);
+    silentSamples = wetSilent ? silentSamples + numSamples : 0;
+    idle = silentSamples > getStateMemorySamples(p, latency);
+
+    // The dry line always runs so its history is ready when the FFT path or oversampling switches on
+    for (int ch = 0; ch < numCh; ++ch)
+    {
+        SampleType* dry = state.dryBuffer.getWritePointer(ch);
+        state.dryDelayLine.write(ch, 0, dry, numSamples);
+        if (latency > 0)
+            state.dryDelayLine.read(ch, 0, static_cast<float>(latency), dry, numSamples);
+    }
+    state.dryDelayLine.advance(numSamples);
+
+    // Latency can only be changed from the message thread; publish it for timerCallback
+    pendingLatencySamples.store(latency, std::memory_order_relaxed);
+
+    // The LFO and write head keep running in every mode so switching modes stays in phase
+    if (! lfoRendered)
+    {
+        lfo.setRate(p.lfoRate);
+        lfo.advance(numSamples);
+    }
+    state.delayLine.advance(numSamples);
+    if (state.pendingHistory >= 0)
+    {
+        // A spare being filled follows the line; what was just written still has to be copied
+        state.spareDelayLine->advance(numSamples);
+        state.pendingHistory += numSamples;
+    }
+    state.combEngine.advance(numSamples);
+    state.flangerEngine.advance(numSamples);
+
+    // Apply mix: out = dry * (1 - mix) + wet * mix, or dry + (wet - dry) * mix[i] while it ramps
+    const SampleType* mixRamp = p.mixSmoothing ? widenRamp(p.mixRamp, state.rampBuffer, 0, numSamples) : nullptr;
+    const auto mix = static_cast<SampleType>(p.mix);
+    for (int ch = 0; ch < numCh; ++ch)
+    {
+        const SampleType* dry = state.dryBuffer.getReadPointer(ch);
+        if (p.mixSmoothing)
         {
-            for (auto& f : iirFilter)
-                f.coefficients = iirCoeffs;
+            juce::FloatVectorOperations::subtract(channels[ch], dry, numSamples);
+            juce::FloatVectorOperations::multiply(channels[ch], mixRamp, numSamples);
+            juce::FloatVectorOperations::add(channels[ch], dry, numSamples);
         }
-
-        auto block = juce::dsp::AudioBlock<float>(buffer);
-        for (int ch = 0; ch < numCh; ++ch)
+        else
         {
-            auto monoBlock = block.getSingleChannelBlock(ch);
-            auto ctx = juce::dsp::ProcessContextReplacing<float>(monoBlock);
-            iirFilter[ch].process(ctx);
+            juce::FloatVectorOperations::multiply(channels[ch], mix, numSamples);
+            juce::FloatVectorOperations::addWithMultiply(channels[ch], dry, SampleType(1) - mix, numSamples);
         }
     }
 
-    // Cache pointers
-    std::vector<float*> channelPtrs(numCh);
-    std::vector<float*> delayPtrs(numCh);
-    for (int ch = 0; ch < numCh; ++ch)
+    return true;
+}
+
+void DelayFilterPluginAudioProcessor::processIdle(int numSamples)
+{
+    // Only the parameter ramps, LFO phase and reported latency are kept current
+    for (auto* smoothed : getSmoothedParameters())
+        smoothed->skip(numSamples);
+
+    lfo.setRate(lfoRateSmoothed.getCurrentValue());
+    lfo.advance(numSamples);
+
+    pendingLatencySamples.store(getLatencyForChain(getModeChain()), std::memory_order_relaxed);
+}
+
+template <typename SampleType>
+int DelayFilterPluginAudioProcessor::processChain(EngineState<SampleType>& state, SampleType* const* channels, const BlockParams& p, int numSamples)
+{
+    int latency = 0;
+
+    for (int i = 0; i < p.chain.numStages; ++i)
     {
-        channelPtrs[ch] = buffer.getWritePointer(ch);
-        delayPtrs[ch] = delayBuffer.getWritePointer(ch);
+        BlockParams stage = p;
+        stage.mode = p.chain.stages[i];
+        stage.effectiveDelayMs = getEffectiveDelayMs(stage);
+
+        switch (stage.mode)
+        {
+        case FilterMode::comb:    processCombKernel<SampleType, false>(state, channels, stage, state.combEngine, state.combTap, numSamples); break;
+        case FilterMode::fir:     processFirKernel(state, channels, stage, numSamples); break;
+        case FilterMode::iir:     processIirKernel(state, channels, stage, numSamples); break;
+        case FilterMode::phaser:  processPhaserKernel(state, channels, stage, numSamples); break;
+        case FilterMode::flanger: processCombKernel<SampleType, true>(state, channels, stage, state.flangerEngine, state.combTap, numSamples); break;
+        }
+
+        if (stage.mode == FilterMode::fir)
+            latency += firEngine.getLatencySamples();
     }
 
-    // LFO setup
-    double currentLfoPhase = lfoPhase;
-    double lfoIncrement = 2.0 * juce::MathConstants<double>::pi * lfoRate / currentSampleRate;
+    return latency;
+}
 
-    // Process per sample, synced across channels
-    int currentWritePos = writePosition;
-    for (int i = 0; i < numSamples; ++i)
+int DelayFilterPluginAudioProcessor::getStateMemorySamples(const BlockParams& p, int latency) const noexcept
+{
+    // How long energy can sit in the state without reaching the output: the longest delay read
+    // for the delay-line modes, one cutoff period (or the allpass decay) for the filters. In a
+    // chain it can sit in every stage in turn.
+    double memoryMs = 0.0;
+    for (int i = 0; i < p.chain.numStages; ++i)
     {
-        // Advance smoothing for IIR (call per sample to properly smooth over time)
-        if (isIIR)
+        BlockParams stage = p;
+        stage.mode = p.chain.stages[i];
+        const double delayMs = getEffectiveDelayMs(stage);
+
+        switch (stage.mode)
         {
-            (void)smoothFilterFreq.getNextValue();
-            (void)smoothQ.getNextValue();
+        case FilterMode::comb:    memoryMs += delayMs; break;
+        case FilterMode::flanger: memoryMs += delayMs + p.lfoDepthMs; break;
+        case FilterMode::fir:     memoryMs += juce::jmin(1000.0 * maxFirSpanSeconds, delayMs); break;
+        case FilterMode::iir:     memoryMs += 1000.0 / p.filterFreq; break;
+        case FilterMode::phaser:
+            memoryMs += juce::jmax(1000.0 / p.filterFreq,
+                                   1000.0 * PhaserEngine<float>::getDecaySamples(p.phaserStages, p.phaserFeedback, silenceThreshold) / currentSampleRate);
+            break;
         }
+    }
+
+    return static_cast<int>(std::ceil(memoryMs * 0.001 * currentSampleRate)) + latency;
+}
+
+int DelayFilterPluginAudioProcessor::getOversamplingOrder(FilterMode mode) const noexcept
+{
+    // FIR and the SVF are linear and don't alias; only the modulated/feedback modes oversample
+    if (mode == FilterMode::fir || mode == FilterMode::iir)
+        return 0;
+
+    const int realtimeOrder = static_cast<int>(oversamplingParam->load());
+    const int offlineChoice = static_cast<int>(offlineOversamplingParam->load());
+    const int order = (isNonRealtime() && offlineChoice > 0) ? offlineChoice - 1 : realtimeOrder;
+    return juce::jlimit(0, maxOversamplingOrder, order);
+}
+
+int DelayFilterPluginAudioProcessor::getOversamplingKey(int order) const noexcept
+{
+    return (isNonRealtime() ? 1 : 0) * maxOversamplingOrder + order - 1;
+}
+
+int DelayFilterPluginAudioProcessor::getOversamplingKey() const noexcept
+{
+    const auto chain = getModeChain();
+    const int order = chain.chained || chain.numStages == 0 ? 0 : getOversamplingOrder(chain.stages[0]);
+    return order > 0 ? getOversamplingKey(order) : -1;
+}
+
+template <typename SampleType>
+std::unique_ptr<DelayFilterPluginAudioProcessor::OversampledPath<SampleType>> DelayFilterPluginAudioProcessor::makeOversampledPath(int key) const
+{
+    // The comb engine only needs maxCombDelayMs at this path's own rate
+    using Oversampling = juce::dsp::Oversampling<SampleType>;
+    const int quality = key / maxOversamplingOrder;
+    const int order = key % maxOversamplingOrder + 1;
+    const auto filterType = quality == 0 ? Oversampling::filterHalfBandPolyphaseIIR : Oversampling::filterHalfBandFIREquiripple;
+    const double rate = currentSampleRate * (1 << order);
+
+    auto path = std::make_unique<OversampledPath<SampleType>>();
+    path->key = key;
+    path->oversampler = std::make_unique<Oversampling>(static_cast<size_t>(numChannels), static_cast<size_t>(order), filterType, quality == 1, true);
+    path->oversampler->initProcessing(static_cast<size_t>(maxBlockSize));
+    path->combEngine.prepare(numChannels, static_cast<int>(std::ceil(maxCombDelayMs * 0.001 * rate)) + 1);
+    path->combTap.prepare(rate);
+    return path;
+}
+
+template <typename SampleType>
+void DelayFilterPluginAudioProcessor::buildSpareOversampledPath(EngineState<SampleType>& state)
+{
+    if (state.maxBlockSize <= 0)
+        return;
+
+    // Same handshake as buildSpareDelayLine
+    const int handover = oversamplingHandover.load(std::memory_order_acquire);
+    if (handover == handoverReady)
+        return;
+    if (handover == handoverRetired)
+    {
+        state.spareOversampledPath.reset();
+        oversamplingHandover.store(handoverIdle, std::memory_order_release);
+    }
+
+    const int key = getOversamplingKey();
+    if (key < 0 || key == activeOversamplingKey.load(std::memory_order_relaxed))
+        return;
+
+    state.spareOversampledPath = makeOversampledPath<SampleType>(key);
+    oversamplingHandover.store(handoverReady, std::memory_order_release);
+}
+
+template <typename SampleType>
+void DelayFilterPluginAudioProcessor::swapInSpareOversampledPath(EngineState<SampleType>& state)
+{
+    if (oversamplingHandover.load(std::memory_order_acquire) != handoverReady)
+        return;
 
-        // Compute LFO
-        double lfoValD = std::sin(currentLfoPhase);
-        currentLfoPhase += lfoIncrement;
-        if (currentLfoPhase >= 2.0 * juce::MathConstants<double>::pi)
-            currentLfoPhase -= 2.0 * juce::MathConstants<double>::pi;
-        float lfoVal = static_cast<float>(lfoValD);
-        float modMs = lfoDepthMs * lfoVal;
-
-        // Read inputs for this sample (dry)
-        float ins[2];
-        for (int ch = 0; ch < numCh; ++ch)
-            ins[ch] = isIIR ? dryBuffer.getSample(ch, i) : channelPtrs[ch][i];
-
-        // Process each channel
-        float wets[2];
-        float toWrites[2];
-        for (int ch = 0; ch < numCh; ++ch)
+    std::swap(state.oversampledPath, state.spareOversampledPath);
+    activeOversamplingKey.store(state.oversampledPath->key, std::memory_order_relaxed);
+    oversamplingHandover.store(handoverRetired, std::memory_order_release);
+}
+
+template <typename SampleType>
+int DelayFilterPluginAudioProcessor::processOversampled(EngineState<SampleType>& state, SampleType* const* channels, const BlockParams& p, int numSamples)
+{
+    auto& path = *state.oversampledPath;
+    auto& oversampler = *path.oversampler;
+
+    juce::dsp::AudioBlock<SampleType> block(channels, static_cast<size_t>(numChannels), static_cast<size_t>(numSamples));
+    auto upBlock = oversampler.processSamplesUp(block);
+
+    SampleType* upChannels[maxChannels];
+    for (int ch = 0; ch < numChannels; ++ch)
+        upChannels[ch] = upBlock.getChannelPointer(static_cast<size_t>(ch));
+
+    const BlockParams up = makeOversampledParams(p, numSamples);
+    const int upSamples = numSamples * up.oversamplingFactor;
+
+    switch (p.mode)
+    {
+    case FilterMode::comb:    processCombKernel<SampleType, false>(state, upChannels, up, path.combEngine, path.combTap, upSamples); break;
+    case FilterMode::phaser:  processPhaserKernel(state, upChannels, up, upSamples); break;
+    case FilterMode::flanger: processCombKernel<SampleType, true>(state, upChannels, up, path.combEngine, path.combTap, upSamples); break;
+    case FilterMode::fir:
+    case FilterMode::iir:     jassertfalse; break;
+    }
+    if (p.mode == FilterMode::comb || p.mode == FilterMode::flanger)
+        path.combEngine.advance(upSamples);
+
+    oversampler.processSamplesDown(block);
+    return oversamplingLatencies[path.key / maxOversamplingOrder][p.oversamplingOrder - 1];
+}
+
+DelayFilterPluginAudioProcessor::BlockParams DelayFilterPluginAudioProcessor::makeOversampledParams(const BlockParams& p, int numSamples)
+{
+    BlockParams up = p;
+    up.oversamplingFactor = 1 << p.oversamplingOrder;
+    up.sampleRate = p.sampleRate * up.oversamplingFactor;
+
+    // Ramps are held across each group of oversampled samples; they move far too slowly for that to be audible
+    const float* sources[] = { p.feedbackRamp, p.filterFreqRamp, p.lfoDepthRamp };
+    for (int row = 0; row < 3; ++row)
+    {
+        const float* src = sources[row];
+        float* dest = oversampledRamps.getWritePointer(row);
+        for (int i = 0; i < numSamples; ++i)
+            for (int k = 0; k < up.oversamplingFactor; ++k)
+                *dest++ = src[i];
+    }
+
+    up.feedbackRamp = oversampledRamps.getReadPointer(0);
+    up.filterFreqRamp = oversampledRamps.getReadPointer(1);
+    up.lfoDepthRamp = oversampledRamps.getReadPointer(2);
+    up.mixRamp = nullptr; // mix is applied at the host rate
+    up.iirQRamp = nullptr;
+    return up;
+}
+
+DelayStorage DelayFilterPluginAudioProcessor::getDelayStorage() const noexcept
+{
+    return static_cast<DelayStorage>(juce::jlimit(0, 1, static_cast<int>(delayStorageParam->load())));
+}
+
+int DelayFilterPluginAudioProcessor::getRequiredDelaySamples() const noexcept
+{
+    // Only the direct FIR path reads the line, back over its whole tap span; the comb and
+    // flanger have their own engines. On the FFT path it stays sized for the longest direct
+    // span, so dropping back to partitionedThreshold taps or fewer has the history it reads.
+    double delayMs = 0.0;
+    const int taps = juce::jmin(static_cast<int>(tapsParam->load()), FirEngine::partitionedThreshold);
+    if (getModeChain().contains(FilterMode::fir))
+    {
+        const double periodMs = 1000.0 / juce::jmax(20.0f, filterFreqParam->load());
+        delayMs = juce::jmin(1000.0 * maxFirSpanSeconds, periodMs * (taps - 1));
+    }
+    return static_cast<int>(std::ceil(delayMs * 0.001 * currentSampleRate)) + 1;
+}
+
+int DelayFilterPluginAudioProcessor::getRequiredFirPartitions() const noexcept
+{
+    // Only a partitioned FIR stage needs the FFT kernel, as long as its tap span
+    const int taps = static_cast<int>(tapsParam->load());
+    if (! getModeChain().contains(FilterMode::fir) || taps <= FirEngine::partitionedThreshold)
+        return 0;
+
+    const double spacing = currentSampleRate / juce::jmax(20.0f, filterFreqParam->load());
+    return FirEngine::getPartitionsForSpan(juce::jmin(maxFirSpanSeconds * currentSampleRate, spacing * (taps - 1)));
+}
+
+void DelayFilterPluginAudioProcessor::requestDelaySamples(int numSamples) noexcept
+{
+    int current = requiredDelaySamples.load(std::memory_order_relaxed);
+    while (numSamples > current && ! requiredDelaySamples.compare_exchange_weak(current, numSamples, std::memory_order_relaxed))
+    {
+    }
+}
+
+template <typename SampleType>
+void DelayFilterPluginAudioProcessor::buildSpareDelayLine(EngineState<SampleType>& state)
+{
+    if (state.maxBlockSize <= 0)
+        return;
+
+    // A ready spare belongs to the audio thread until it hands the old line back
+    const int handover = delayLineHandover.load(std::memory_order_acquire);
+    if (handover == handoverReady)
+        return;
+    if (handover == handoverRetired)
+    {
+        state.spareDelayLine.reset();
+        delayLineHandover.store(handoverIdle, std::memory_order_release);
+    }
+
+    // Parameters are checked here too, so a change is usually covered before a reader needs it
+    requestDelaySamples(getRequiredDelaySamples());
+    const int required = requiredDelaySamples.load(std::memory_order_relaxed);
+    const int available = activeMaxDelaySamples.load(std::memory_order_relaxed);
+    const auto storage = getDelayStorage();
+    if (required <= available && static_cast<int>(storage) == activeDelayStorage.load(std::memory_order_relaxed))
+        return;
+
+    // Grow with headroom so a slow sweep doesn't rebuild on every tick
+    const int size = required > available ? required + required / 2 : available;
+    state.spareDelayLine = std::make_unique<DelayLine<SampleType>>();
+    state.spareDelayLine->prepare(numChannels, size, maxBlockSize, storage);
+    delayLineHandover.store(handoverReady, std::memory_order_release);
+}
+
+template <typename SampleType>
+void DelayFilterPluginAudioProcessor::swapInSpareDelayLine(EngineState<SampleType>& state, int numSamples)
+{
+    if (delayLineHandover.load(std::memory_order_acquire) != handoverReady)
+        return;
+
+    // Only the span readers have asked for is carried over, oldest first, one bounded slice per
+    // block. Each slice outpaces the block, so the copy always catches up.
+    auto& spare = *state.spareDelayLine;
+    if (state.pendingHistory < 0)
+        state.pendingHistory = juce::jmin(requiredDelaySamples.load(std::memory_order_relaxed),
+                                          state.delayLine.getMaxDelaySamples(), spare.getMaxDelaySamples());
+
+    const int slice = juce::jmin(state.pendingHistory, juce::jmax(minHistorySlice, 2 * numSamples));
+    spare.copyHistoryFrom(state.delayLine, state.pendingHistory, slice, state.wetBuffer.getWritePointer(0), state.wetBuffer.getNumSamples());
+    state.pendingHistory -= slice;
+    if (state.pendingHistory > 0)
+        return;
+
+    std::swap(state.delayLine, spare);
+    state.pendingHistory = -1;
+
+    activeMaxDelaySamples.store(state.delayLine.getMaxDelaySamples(), std::memory_order_relaxed);
+    activeDelayStorage.store(static_cast<int>(state.delayLine.getStorage()), std::memory_order_relaxed);
+    delayLineHandover.store(handoverRetired, std::memory_order_release);
+}
+
+void DelayFilterPluginAudioProcessor::renderLfo(const BlockParams& p, int numSamples)
+{
+    if (lfoRendered)
+        return;
+    lfoRendered = true;
+
+    // Rendered at the kernel's rate; the control interval scales with it to keep the cost flat
+    lfo.setRate(p.lfoRate / static_cast<float>(p.oversamplingFactor));
+    lfo.setControlInterval(lfoControlInterval * p.oversamplingFactor);
+    lfo.setShape(static_cast<ModulationSource::Shape>(p.lfoShape));
+    lfo.setStereoOffset(p.lfoStereoDegrees / 360.0f);
+    lfo.process(lfoBuffer.getArrayOfWritePointers(), numChannels, numSamples);
+    lfoDisplayValue.store(lfoBuffer.getSample(0, numSamples - 1), std::memory_order_relaxed);
+}
+
+// Comb: feedforward single tap with feedback, interpolated.
+// Flanger: the same comb with the read position swept by the LFO.
+// Both run in CombEngine, one SIMD register per group of channels.
+template <typename SampleType, bool modulated>
+void DelayFilterPluginAudioProcessor::processCombKernel(EngineState<SampleType>& state, SampleType* const* channels, const BlockParams& p,
+                                                        CombEngine<SampleType>& engine, DelayTapFade& tap, int numSamples)
+{
+    const float samplesPerMs = 0.001f * static_cast<float>(p.sampleRate);
+    const SampleType* feedbackRamp = p.feedbackSmoothing ? widenRamp(p.feedbackRamp, state.rampBuffer, 1, numSamples) : nullptr;
+    const auto feedback = static_cast<SampleType>(p.feedback);
+
+    if constexpr (! modulated)
+    {
+        // The comb reads at one delay per block; a filterFreq move crossfades to the new read
+        // position (see DelayTapFade) rather than sweeping it per sample
+        tap.setDelay(p.effectiveDelayMs * samplesPerMs);
+        const SampleType* fadeGains = nullptr;
+        if (tap.isFading())
         {
-            float in = ins[ch];
-            float wet = in;
+            SampleType* gains = state.tapFadeBuffer.getWritePointer(0);
+            tap.getGains(gains, numSamples);
+            fadeGains = gains;
+        }
 
-            if (!isIIR)
-            {
-                switch (filterType)
-                {
-                case 0: // Comb: feedforward single tap with feedback, interpolated
-                {
-                    float delaySamplesF = effectiveDelayMs * 0.001f * static_cast<float>(currentSampleRate);
-                    float readPos = static_cast<float>(currentWritePos) - delaySamplesF + static_cast<float>(maxDelaySamples);
-                    readPos = fmodf(readPos, maxDelaySamplesF);
-                    if (readPos < 0.0f) readPos += maxDelaySamplesF;
-                    int idx0 = static_cast<int>(readPos);
-                    float frac = readPos - static_cast<float>(idx0);
-                    int idx1 = (idx0 + 1) % maxDelaySamples;
-                    float delayed = (1.0f - frac) * delayPtrs[ch][idx0] + frac * delayPtrs[ch][idx1];
-                    wet = in + feedback * delayed;
-                    toWrites[ch] = wet;
-                    break;
-                }
-                case 1: // FIR: multi-tap feedforward, interpolated, with Hann window
-                {
-                    if (taps < 1) taps = 1;
-                    float gainPerTap = tapGain / static_cast<float>(taps);
-                    wet = 0.0f;
-                    float totalSpanMs = effectiveDelayMs;
-                    // t=0: current input
-                    if (taps > 0)
-                    {
-                        float frac_t = 0.0f;
-                        float window = 0.5f * (1.0f - std::cos(2.0f * juce::MathConstants<float>::pi * frac_t));
-                        wet += in * gainPerTap * window;
-                    }
-                    // t=1 to taps-1: past samples
-                    for (int t = 1; t < taps; ++t)
-                    {
-                        float frac_t = static_cast<float>(t) / static_cast<float>(taps - 1);
-                        float tapDms = frac_t * totalSpanMs;
-                        float tapDsF = tapDms * 0.001f * static_cast<float>(currentSampleRate);
-                        float tapReadPos = static_cast<float>(currentWritePos) - tapDsF + static_cast<float>(maxDelaySamples);
-                        tapReadPos = fmodf(tapReadPos, maxDelaySamplesF);
-                        if (tapReadPos < 0.0f) tapReadPos += maxDelaySamplesF;
-                        int idx0 = static_cast<int>(tapReadPos);
-                        float frac = tapReadPos - static_cast<float>(idx0);
-                        int idx1 = (idx0 + 1) % maxDelaySamples;
-                        float tapVal = (1.0f - frac) * delayPtrs[ch][idx0] + frac * delayPtrs[ch][idx1];
-                        // Hann window
-                        float window = 0.5f * (1.0f - std::cos(2.0f * juce::MathConstants<float>::pi * frac_t));
-                        wet += tapVal * gainPerTap * window;
-                    }
-                    toWrites[ch] = in;
-                    break;
-                }
-                case 3: // Phaser: 2 allpass stages, frequency dependent
-                {
-                    double w0 = 2.0 * juce::MathConstants<double>::pi * filterFreq / currentSampleRate;
-                    double tan_half = std::tan(w0 / 2.0);
-                    float base_a = static_cast<float>((1.0 - tan_half) / (1.0 + tan_half));
-                    float mod_amount = lfoDepthMs / 20.0f; // Scale to reasonable modulation
-                    float a = base_a + lfoVal * mod_amount;
-                    a = juce::jlimit(-0.99f, 0.99f, a);
-                    // Stage 1
-                    float out1 = ap_x1[ch] + a * (in - ap_y1[ch]);
-                    // Stage 2
-                    float out2 = ap_x2[ch] + a * (out1 - ap_y2[ch]);
-                    wet = in + feedback * (out2 - in); // Mix dry + (allpass - dry) for phasing
-                    // Update states
-                    ap_y1[ch] = out1;
-                    ap_x1[ch] = in;
-                    ap_y2[ch] = out2;
-                    ap_x2[ch] = out1;
-                    toWrites[ch] = in;
-                    break;
-                }
-                case 4: // Flanger: modulated feedback comb, interpolated
-                {
-                    float modDelayMs = effectiveDelayMs + modMs;
-                    float delaySamplesF = juce::jlimit(0.1f, 1000.0f, modDelayMs) * 0.001f * static_cast<float>(currentSampleRate);
-                    float readPos = static_cast<float>(currentWritePos) - delaySamplesF + static_cast<float>(maxDelaySamples);
-                    readPos = fmodf(readPos, maxDelaySamplesF);
-                    if (readPos < 0.0f) readPos += maxDelaySamplesF;
-                    int idx0 = static_cast<int>(readPos);
-                    float frac = readPos - static_cast<float>(idx0);
-                    int idx1 = (idx0 + 1) % maxDelaySamples;
-                    float delayed = (1.0f - frac) * delayPtrs[ch][idx0] + frac * delayPtrs[ch][idx1];
-                    wet = in + feedback * delayed;
-                    toWrites[ch] = wet;
-                    break;
-                }
-                default:
-                    wet = in;
-                    toWrites[ch] = in;
-                }
-            }
-            else
-            {
-                // For IIR, wet is already in buffer
-                wet = channelPtrs[ch][i];
-                toWrites[ch] = in; // not used
-            }
-            wets[ch] = wet;
+        engine.processFixed(channels, numChannels, tap.getDelay(), tap.getPreviousDelay(), fadeGains, feedbackRamp, feedback, numSamples);
+        tap.advance(numSamples);
+    }
+    else
+    {
+        // Per-sample, per-channel delay in samples
+        renderLfo(p, numSamples);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            float* delaySamples = modBuffer.getWritePointer(ch);
+            const float* mod = lfoBuffer.getReadPointer(ch);
+            for (int i = 0; i < numSamples; ++i)
+                delaySamples[i] = juce::jlimit(0.1f, 1000.0f, 1000.0f / p.filterFreqRamp[i] + p.lfoDepthRamp[i] * mod[i]);
 
-            // Apply mix
-            float dry = ins[ch];
-            float outSample = dry * (1.0f - mix) + wet * mix;
-            channelPtrs[ch][i] = outSample;
+            juce::FloatVectorOperations::multiply(delaySamples, samplesPerMs, numSamples);
         }
 
-        // Write to delay buffer for this sample (only for delay-based filters)
-        bool writeDelay = (filterType == 0 || filterType == 1 || filterType == 4);
-        if (writeDelay)
+        engine.processModulated(channels, numChannels, modBuffer.getArrayOfReadPointers(), feedbackRamp, feedback, numSamples);
+    }
+}
+
+// FIR: multi-tap feedforward, interpolated, with Hann window
+template <typename SampleType>
+void DelayFilterPluginAudioProcessor::processFirKernel(EngineState<SampleType>& state, SampleType* const* channels, const BlockParams& p, int numSamples)
+{
+    // Taps are spaced one filterFreq period apart; the table only changes with the parameters
+    const float spacing = static_cast<float>(currentSampleRate) / p.filterFreq;
+    firEngine.setShape(p.taps, p.tapGain, spacing);
+
+    // The direct path reads back the whole span; taps past the line's reach are dropped until
+    // timerCallback has grown it. The FFT path keeps it long enough for 64 direct taps.
+    const float maxTapDelay = static_cast<float>(state.delayLine.getMaxDelaySamples());
+    if (! firEngine.usesPartitionedPath())
+        requestDelaySamples(static_cast<int>(std::ceil(firEngine.getMaxTapDelay())) + 1);
+    else
+        requestDelaySamples(static_cast<int>(std::ceil(juce::jmin(maxFirSpanSeconds * currentSampleRate, spacing * (FirEngine::partitionedThreshold - 1.0)))) + 1);
+
+    // A tap table that just moved is crossfaded in; otherwise one read per tap
+    const SampleType* fadeGains = nullptr;
+    if (! firEngine.usesPartitionedPath() && firEngine.isFading())
+    {
+        SampleType* gains = state.tapFadeBuffer.getWritePointer(0);
+        firEngine.getFadeGains(gains, numSamples);
+        fadeGains = gains;
+    }
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        // Write the input block first (FIR has no feedback), then gather each tap over the block.
+        // The line is kept current on the FFT path too; getRequiredDelaySamples keeps it long
+        // enough for the direct path's span, so dropping back to it has history.
+        state.delayLine.write(ch, 0, channels[ch], numSamples);
+
+        SampleType* wet = state.wetBuffer.getWritePointer(ch);
+
+        if (firEngine.usesPartitionedPath())
         {
-            for (int ch = 0; ch < numCh; ++ch)
+            // The dry path is aligned with the partition latency in processSubBlock
+            firEngine.processPartitioned(ch, channels[ch], wet, numSamples);
+        }
+        else
+        {
+            const int numTaps = firEngine.getNumActiveTaps();
+            const float* tapDelays = firEngine.getTapDelays();
+            const float* tapGains = firEngine.getTapGains();
+
+            juce::FloatVectorOperations::clear(wet, numSamples);
+            for (int t = 0; t < numTaps && tapDelays[t] <= maxTapDelay; ++t)
+                state.delayLine.addFrom(ch, 0, tapDelays[t], tapGains[t], wet, numSamples);
+
+            if (fadeGains != nullptr)
             {
-                delayPtrs[ch][currentWritePos] = toWrites[ch];
+                // wet = old + gain * (new - old), old being the previous tap table
+                const float* previousDelays = firEngine.getPreviousTapDelays();
+                const float* previousGains = firEngine.getPreviousTapGains();
+                SampleType* old = state.tapFadeBuffer.getWritePointer(1);
+
+                juce::FloatVectorOperations::clear(old, numSamples);
+                for (int t = 0; t < firEngine.getNumPreviousTaps() && previousDelays[t] <= maxTapDelay; ++t)
+                    state.delayLine.addFrom(ch, 0, previousDelays[t], previousGains[t], old, numSamples);
+
+                juce::FloatVectorOperations::subtract(wet, old, numSamples);
+                juce::FloatVectorOperations::multiply(wet, fadeGains, numSamples);
+                juce::FloatVectorOperations::add(wet, old, numSamples);
             }
         }
 
-        // Advance write position
-        currentWritePos = (currentWritePos + 1) % maxDelaySamples;
+        juce::FloatVectorOperations::copy(channels[ch], wet, numSamples);
     }
 
-    // Update LFO phase and write position
-    lfoPhase = currentLfoPhase;
-    writePosition = currentWritePos;
+    firEngine.advance(numSamples);
+}
+
+template <typename SampleType>
+void DelayFilterPluginAudioProcessor::processIirKernel(EngineState<SampleType>& state, SampleType* const* channels, const BlockParams& p, int numSamples)
+{
+    // The SVF absorbs a new cutoff/Q every sample straight from the parameter ramps
+    state.iirEngine.setType(static_cast<SvfType>(juce::jlimit(0, 2, p.iirType)));
+    state.iirEngine.setNumStages(p.iirSlope + 1);
+    state.iirEngine.process(channels, numChannels, p.filterFreqRamp, p.iirQRamp, numSamples);
+}
+
+// Phaser: 2 to 12 allpass stages around filterFreq, swept by the LFO (see PhaserEngine)
+template <typename SampleType>
+void DelayFilterPluginAudioProcessor::processPhaserKernel(EngineState<SampleType>& state, SampleType* const* channels, const BlockParams& p, int numSamples)
+{
+    // lfoDepth ms scaled to a reasonable modulation amount; a coefficient step sweeps about
+    // factor times more Hz when oversampled, so the scale shrinks with it
+    const float mod_scale = 1.0f / (20.0f * static_cast<float>(p.oversamplingFactor));
+
+    renderLfo(p, numSamples);
+
+    auto& phaser = state.phaserEngine;
+    phaser.setNumStages(p.phaserStages);
+    phaser.setFrequency(p.filterFreq, p.phaserSpread, p.sampleRate);
+    phaser.process(channels, numChannels, lfoBuffer.getArrayOfReadPointers(), p.lfoDepthRamp, mod_scale,
+                   p.feedbackRamp, p.phaserFeedback, lfoControlInterval * p.oversamplingFactor, numSamples);
 }
 
 void DelayFilterPluginAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    auto state = apvts.copyState();
-    if (state.isValid())
-    {
-        if (auto xml = state.createXml())
-        {
-            copyXmlToBinary(*xml, destData);
-        }
-    }
+    PresetBank::writeState(*this, destData);
 }
 
 void DelayFilterPluginAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
+    if (PresetBank::readState(*this, data, sizeInBytes))
+        return;
+
+    // Sessions saved before the binary format hold the APVTS tree as XML
     std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
     if (xmlState != nullptr)
     {
         juce::ValueTree tree(juce::ValueTree::fromXml(*xmlState));
         if (tree.isValid() && tree.getType() == apvts.state.getType())
+        {
+            // As with the binary format, parameters the session has no entry for go back to
+            // their defaults rather than keeping whatever was loaded before
+            std::vector<juce::RangedAudioParameter*> missing;
+            for (auto* param : getParameters())
+                if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(param); ranged != nullptr && ! tree.getChildWithProperty("id", ranged->getParameterID()).isValid())
+                    missing.push_back(ranged);
+
             apvts.replaceState(std::move(tree));
+
+            for (auto* ranged : missing)
+                if (ranged->getValue() != ranged->getDefaultValue())
+                    ranged->setValueNotifyingHost(ranged->getDefaultValue());
+        }
     }
 }
 
 void DelayFilterPluginAudioProcessor::setCurrentProgram(int index)
 {
-    (void)index;
+    presets.loadPreset(index);
 }
 
 const juce::String DelayFilterPluginAudioProcessor::getProgramName(int index)
 {
-    (void)index;
-    return {};
+    return presets.getPresetName(index);
 }
 
 void DelayFilterPluginAudioProcessor::changeProgramName(int index, const juce::String& newName)
@@ -2,8 +2,20 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "CombEngine.h"
+#include "CpuMeter.h"
+#include "DelayLine.h"
+#include "FilterResponse.h"
+#include "FirEngine.h"
+#include "ModulationSource.h"
+#include "PhaserEngine.h"
+#include "PresetBank.h"
+#include "StateVariableFilter.h"
+#include "SmoothedParameter.h"
+#include "SpectrumFeed.h"
 
-class DelayFilterPluginAudioProcessor : public juce::AudioProcessor
+class DelayFilterPluginAudioProcessor : public juce::AudioProcessor,
+                                        private juce::Timer
 {
 public:
     DelayFilterPluginAudioProcessor();
@@ -14,6 +26,8 @@ public:
     void releaseResources() override;
     bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock(juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override { return true; }
 
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override { return true; }
@@ -21,10 +35,10 @@ public:
     const juce::String getName() const override { return "DelayFilterPlugin"; }
     bool acceptsMidi() const override { return false; }
     bool producesMidi() const override { return false; }
-    double getTailLengthSeconds() const override { return 0.0; }
+    double getTailLengthSeconds() const override;
 
-    int getNumPrograms() override { return 1; }
-    int getCurrentProgram() override { return 0; }
+    int getNumPrograms() override { return presets.getNumPresets(); }
+    int getCurrentProgram() override { return presets.getCurrentPreset(); }
     void setCurrentProgram(int index) override;
     const juce::String getProgramName(int index) override;
     void changeProgramName(int index, const juce::String& newName) override;
@@ -36,21 +50,274 @@ public:
     juce::AudioProcessorValueTreeState apvts;
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameters();
 
+    PresetBank& getPresetBank() noexcept { return presets; }
+
+    // processBlock timing, drained on the message thread by timerCallback
+    CpuMeter& getCpuMeter() noexcept { return cpuMeter; }
+
+    // Editor response display: parameter snapshot for FilterResponse (message thread) and
+    // the post-FX samples for the spectrum
+    FilterResponse::Settings getResponseSettings() const;
+    SpectrumFeed& getSpectrumFeed() noexcept { return spectrumFeed; }
+
 private:
-    // Delay buffer and indices
-    juce::AudioBuffer<float> delayBuffer;
-    int writePosition{ 0 };
+    void timerCallback() override;
+
+    enum class FilterMode { comb = 0, fir, iir, phaser, flanger };
+
+    // The modes a block runs, in order: the Filter Type alone, or with "routing" set to Chain
+    // the chain slots in series (each mode at most once, since each has one engine)
+    static constexpr int maxChainStages = 4;
+    struct ModeChain
+    {
+        FilterMode stages[maxChainStages]{};
+        int numStages{ 0 };
+        bool chained{ false };
+
+        bool contains(FilterMode mode) const noexcept { return std::find(stages, stages + numStages, mode) != stages + numStages; }
+    };
+    ModeChain getModeChain() const noexcept;
+
+    // Per-block parameter snapshot plus the invariants every kernel needs. Continuous values
+    // are the smoothed value at the end of the block; the ramps hold one value per sample.
+    struct BlockParams
+    {
+        FilterMode mode{ FilterMode::comb }; // the current stage; the first one outside a chain
+        ModeChain chain;
+        float mix{ 0.5f }, delayMs{ 20.0f }, feedback{ 0.0f };
+        int taps{ 2 };
+        float tapGain{ 0.5f }, lfoRate{ 0.5f }, lfoDepthMs{ 2.0f };
+        int lfoShape{ 0 };
+        float lfoStereoDegrees{ 0.0f };
+        int iirType{ 0 };
+        float filterFreq{ 1000.0f }, iirQ{ 0.707f };
+        int iirSlope{ 0 };
+        int phaserStages{ 2 };
+        float phaserSpread{ 0.0f }, phaserFeedback{ 0.0f };
+        float effectiveDelayMs{ 20.0f };
+        int oversamplingOrder{ 0 };
+
+        // Rate the kernel runs at (the host rate times the oversampling factor)
+        double sampleRate{ 44100.0 };
+        int oversamplingFactor{ 1 };
+
+        const float* mixRamp{ nullptr };
+        const float* feedbackRamp{ nullptr };
+        const float* filterFreqRamp{ nullptr };
+        const float* iirQRamp{ nullptr };
+        const float* lfoDepthRamp{ nullptr };
+        bool mixSmoothing{ false }, feedbackSmoothing{ false }, filterFreqSmoothing{ false };
+    };
+
+    static constexpr int maxChannels = 16;
+    static constexpr int maxOversamplingOrder = 3;
+
+    // Comb/phaser/flanger oversampling at one factor and quality: polyphase IIR half-bands for
+    // realtime, linear-phase FIR half-bands for offline renders. key is quality *
+    // maxOversamplingOrder + order - 1 (see getOversamplingKey); the comb state belongs to that rate.
+    template <typename SampleType>
+    struct OversampledPath
+    {
+        int key{ -1 };
+        std::unique_ptr<juce::dsp::Oversampling<SampleType>> oversampler;
+        CombEngine<SampleType> combEngine;
+        DelayTapFade combTap;
+    };
+
+    // Everything that holds audio, in the precision the host processes in. Only the state
+    // matching isUsingDoublePrecision() is allocated in prepareToPlay.
+    template <typename SampleType>
+    struct EngineState
+    {
+        juce::AudioBuffer<SampleType> dryBuffer, wetBuffer;
+        juce::AudioBuffer<SampleType> rampBuffer; // mix / feedback ramps widened to SampleType
+        juce::AudioBuffer<SampleType> tapFadeBuffer; // tap crossfade gains, and the second read
+        int maxBlockSize{ 0 };
+
+        // The FIR's delay line, sized for its tap span, and its replacement while one is being
+        // handed over (see delayLineHandover). pendingHistory counts the samples still to copy
+        // into the spare, -1 when no copy is under way.
+        DelayLine<SampleType> delayLine;
+        std::unique_ptr<DelayLine<SampleType>> spareDelayLine;
+        int pendingHistory{ -1 };
+
+        // Comb and flanger loops, sized for maxCombDelayMs. Outside a chain both modes share
+        // combEngine, so switching between them keeps the history; a chained flanger has its own.
+        CombEngine<SampleType> combEngine, flangerEngine;
+        DelayTapFade combTap; // the comb's read on combEngine
+
+        StateVariableFilter<SampleType> iirEngine;
+
+        // Only the oversampled path the settings ask for is built, and its replacement while one
+        // is being handed over (see oversamplingHandover)
+        std::unique_ptr<OversampledPath<SampleType>> oversampledPath, spareOversampledPath;
+        DelayLine<SampleType> dryDelayLine; // aligns the dry signal with FIR / oversampling latency
+
+        PhaserEngine<SampleType> phaserEngine;
+    };
+
+    template <typename SampleType>
+    EngineState<SampleType>& getEngineState() noexcept
+    {
+        if constexpr (std::is_same_v<SampleType, double>)
+            return doubleState;
+        else
+            return floatState;
+    }
+
+    template <typename SampleType>
+    void prepareEngineState(EngineState<SampleType>& state);
+
+    template <typename SampleType>
+    void processBlockInternal(juce::AudioBuffer<SampleType>& buffer);
+
+    BlockParams readBlockParams(int numSamples);
+    static float getEffectiveDelayMs(const BlockParams& p) noexcept;
+    int getLatencyForMode(FilterMode mode) const noexcept;
+    int getLatencyForChain(const ModeChain& chain) const noexcept;
+
+    // Returns false if the block took the idle bypass
+    template <typename SampleType>
+    bool processSubBlock(EngineState<SampleType>& state, juce::AudioBuffer<SampleType>& buffer, int startSample, int numSamples);
+
+    // Chain routing: every stage in place on the block at the host rate; returns the latency
+    template <typename SampleType>
+    int processChain(EngineState<SampleType>& state, SampleType* const* channels, const BlockParams& p, int numSamples);
+
+    // Oversampled comb/phaser/flanger; returns the latency the oversampler added to the block.
+    // Until the path for the current factor has been handed over, blocks run at the host rate.
+    int getOversamplingOrder(FilterMode mode) const noexcept;
+    int getOversamplingKey(int order) const noexcept;
+    int getOversamplingKey() const noexcept; // for the current settings, -1 if they don't oversample
+    template <typename SampleType>
+    std::unique_ptr<OversampledPath<SampleType>> makeOversampledPath(int key) const;
+    template <typename SampleType>
+    void buildSpareOversampledPath(EngineState<SampleType>& state);
+    template <typename SampleType>
+    void swapInSpareOversampledPath(EngineState<SampleType>& state);
+    template <typename SampleType>
+    int processOversampled(EngineState<SampleType>& state, SampleType* const* channels, const BlockParams& p, int numSamples);
+    BlockParams makeOversampledParams(const BlockParams& p, int numSamples);
+
+    // Block kernels, one per mode (comb and flanger share the feedback-comb kernel). The
+    // caller advances the FIR's delay line and the comb engines.
+    // The comb reads through tap (the flanger's LFO-swept read ignores it).
+    template <typename SampleType, bool modulated>
+    void processCombKernel(EngineState<SampleType>& state, SampleType* const* channels, const BlockParams& p, CombEngine<SampleType>& engine,
+                           DelayTapFade& tap, int numSamples);
+    template <typename SampleType>
+    void processFirKernel(EngineState<SampleType>& state, SampleType* const* channels, const BlockParams& p, int numSamples);
+    template <typename SampleType>
+    void processIirKernel(EngineState<SampleType>& state, SampleType* const* channels, const BlockParams& p, int numSamples);
+    template <typename SampleType>
+    void processPhaserKernel(EngineState<SampleType>& state, SampleType* const* channels, const BlockParams& p, int numSamples);
+
+    // Renders the LFO once per block, however many stages use it
+    void renderLfo(const BlockParams& p, int numSamples);
+    bool lfoRendered{ false };
+
+    // FIR delay line sizing and storage type
+    DelayStorage getDelayStorage() const noexcept;
+    int getRequiredDelaySamples() const noexcept;
+    void requestDelaySamples(int numSamples) noexcept;
+    template <typename SampleType>
+    void buildSpareDelayLine(EngineState<SampleType>& state);
+    template <typename SampleType>
+    void swapInSpareDelayLine(EngineState<SampleType>& state, int numSamples);
+
+    // FFT partitions the FIR stage needs for the current settings (FirEngine grows into them)
+    int getRequiredFirPartitions() const noexcept;
+
+    // Silence detection: once input and wet output have stayed below silenceThreshold for
+    // longer than the delay line / filter state can hold energy, blocks skip the kernels
+    void processIdle(int numSamples);
+    int getStateMemorySamples(const BlockParams& p, int latency) const noexcept;
+    double getModeTailSeconds(FilterMode mode, double level) const;
+
+    // Cached parameter pointers (avoids string lookups on the audio thread)
+    std::atomic<float>* filterTypeParam{ nullptr };
+    std::atomic<float>* mixParam{ nullptr };
+    std::atomic<float>* delayMsParam{ nullptr };
+    std::atomic<float>* feedbackParam{ nullptr };
+    std::atomic<float>* tapsParam{ nullptr };
+    std::atomic<float>* tapGainParam{ nullptr };
+    std::atomic<float>* lfoRateParam{ nullptr };
+    std::atomic<float>* lfoDepthParam{ nullptr };
+    std::atomic<float>* lfoShapeParam{ nullptr };
+    std::atomic<float>* lfoStereoParam{ nullptr };
+    std::atomic<float>* iirTypeParam{ nullptr };
+    std::atomic<float>* filterFreqParam{ nullptr };
+    std::atomic<float>* iirQParam{ nullptr };
+    std::atomic<float>* iirSlopeParam{ nullptr };
+    std::atomic<float>* oversamplingParam{ nullptr };
+    std::atomic<float>* offlineOversamplingParam{ nullptr };
+    std::atomic<float>* delayStorageParam{ nullptr };
+    std::atomic<float>* phaserStagesParam{ nullptr };
+    std::atomic<float>* phaserSpreadParam{ nullptr };
+    std::atomic<float>* phaserFeedbackParam{ nullptr };
+    std::atomic<float>* routingParam{ nullptr };
+    std::atomic<float>* chainStageParams[maxChainStages]{};
+
+    // Main-bus width, fixed in prepareToPlay; kernels handle mono up to maxChannels
+    int numChannels{ 2 };
+
+    // Precision-independent scratch, sized in prepareToPlay at the highest oversampled rate
+    juce::AudioBuffer<float> lfoBuffer, modBuffer; // per-channel LFO output / derived delay or coefficient
+    juce::AudioBuffer<float> oversampledRamps;
+    int maxBlockSize{ 0 };
+
+    EngineState<float> floatState;
+    EngineState<double> doubleState;
+
+    // FIR tap table / partitioned convolution; taps beyond this span are dropped
+    static constexpr double maxFirSpanSeconds = 1.0;
+    FirEngine firEngine;
+    std::atomic<int> pendingLatencySamples{ 0 };
     double currentSampleRate{ 44100.0 };
-    double lfoPhase{ 0.0 };
 
-    // IIR
-    std::array<juce::dsp::IIR::Filter<float>, 2> iirFilter;
-    juce::dsp::IIR::Coefficients<float>::Ptr iirCoeffs;
-    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> smoothFilterFreq;
-    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> smoothQ;
+    // Phaser/flanger LFO, evaluated every lfoControlInterval samples and interpolated
+    static constexpr int lfoControlInterval = 16;
+    ModulationSource lfo;
+    std::atomic<float> lfoDisplayValue{ 0.0f }; // first channel's LFO at the end of the last rendered block
+
+    static constexpr double maxCombDelayMs = 64.0; // comb/flanger: 1000 / 20 Hz + LFO depth
+    int oversamplingLatencies[2][maxOversamplingOrder]{};
+
+    static constexpr float silenceThreshold = 1.0e-5f; // -100 dBFS, also the level the tail is measured to
+    int silentSamples{ 0 };
+    bool idle{ false };
+
+    // The FIR delay line is sized in prepareToPlay for what the current settings reach. When a
+    // parameter needs more, or the storage type changes, timerCallback builds a spare and marks
+    // it ready. The audio thread then copies the history over a slice per block (at least
+    // minHistorySlice samples, and twice the block, so it catches up), swaps the spare in once
+    // it has caught up and marks the old line retired, and the next timerCallback frees it.
+    enum { handoverIdle = 0, handoverReady, handoverRetired };
+    static constexpr int minHistorySlice = 1024;
+    std::atomic<int> delayLineHandover{ handoverIdle };
+    std::atomic<int> requiredDelaySamples{ 0 };  // longest delay a reader has asked for
+    std::atomic<int> activeMaxDelaySamples{ 0 }; // reach of the line the audio thread is using
+    std::atomic<int> activeDelayStorage{ 0 };
+
+    // The oversampled path is handed over the same way when the factor or quality changes
+    std::atomic<int> oversamplingHandover{ handoverIdle };
+    std::atomic<int> activeOversamplingKey{ -1 };
+
+    // Per-sample ramps for every continuous parameter
+    SmoothedParameter mixSmoothed, delayMsSmoothed, feedbackSmoothed, tapGainSmoothed, filterFreqSmoothed,
+                      iirQSmoothed, lfoRateSmoothed, lfoDepthSmoothed, lfoStereoSmoothed, phaserSpreadSmoothed,
+                      phaserFeedbackSmoothed;
+    std::array<SmoothedParameter*, 11> getSmoothedParameters() noexcept;
+
+    // "phaserStages" choice index to allpass count
+    static constexpr int phaserStageCounts[] = { 2, 4, 8, 12 };
+    int getPhaserStages() const noexcept;
+
+    // Factory and user presets, exposed to the host as programs
+    PresetBank presets{ *this };
 
-    // Phaser allpass states (2 stages, stereo)
-    float ap_x1[2]{}, ap_y1[2]{}, ap_x2[2]{}, ap_y2[2]{};
+    CpuMeter cpuMeter;
+    SpectrumFeed spectrumFeed;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DelayFilterPluginAudioProcessor)
 };
\ No newline at end of file
@@ -0,0 +1,227 @@
+// === File: PresetBank.cpp ===
+#include "PresetBank.h"
+
+namespace
+{
+    constexpr int stateMagic = 0x53504644; // "DFPS"
+    constexpr int stateVersion = 1;
+    constexpr int maxStateParameters = 4096;
+    const char* const presetExtension = ".dfpreset";
+
+    using ParameterValues = std::vector<std::pair<juce::String, float>>;
+
+    void writeValues(const ParameterValues& values, juce::MemoryBlock& destData)
+    {
+        destData.reset();
+        juce::MemoryOutputStream out(destData, false);
+        out.writeInt(stateMagic);
+        out.writeInt(stateVersion);
+        out.writeInt(static_cast<int>(values.size()));
+        for (const auto& [id, value] : values)
+        {
+            out.writeString(id);
+            out.writeFloat(value);
+        }
+    }
+
+    // Plain units, choices by index; anything not listed stays at its default
+    ParameterValues makeFactoryValues(std::initializer_list<std::pair<const char*, float>> values)
+    {
+        ParameterValues result;
+        for (const auto& [id, value] : values)
+            result.emplace_back(id, value);
+        return result;
+    }
+
+    juce::CriticalSection libraryLock;
+}
+
+PresetBank::PresetBank(juce::AudioProcessor& processorToControl)
+    : processor(processorToControl), library(getSharedLibrary())
+{
+}
+
+void PresetBank::writeState(const juce::AudioProcessor& processor, juce::MemoryBlock& destData)
+{
+    ParameterValues values;
+    for (auto* param : processor.getParameters())
+        if (auto* ranged = dynamic_cast<const juce::RangedAudioParameter*>(param))
+            values.emplace_back(ranged->getParameterID(), ranged->convertFrom0to1(ranged->getValue()));
+
+    writeValues(values, destData);
+}
+
+bool PresetBank::isBinaryState(const void* data, int sizeInBytes) noexcept
+{
+    return data != nullptr && sizeInBytes >= 12 && static_cast<int>(juce::ByteOrder::littleEndianInt(data)) == stateMagic;
+}
+
+bool PresetBank::readState(juce::AudioProcessor& processor, const void* data, int sizeInBytes)
+{
+    if (! isBinaryState(data, sizeInBytes))
+        return false;
+
+    juce::MemoryInputStream in(data, static_cast<size_t>(sizeInBytes), false);
+    in.readInt(); // magic
+    const int version = in.readInt();
+    const int count = in.readInt();
+    if (version < 1 || count < 0 || count > maxStateParameters)
+        return false;
+
+    // Defaults first, then whatever the blob holds. Later versions may only append fields, so
+    // the (ID, value) list is all this reader needs.
+    const auto& params = processor.getParameters();
+    std::vector<float> normalised;
+    normalised.reserve(static_cast<size_t>(params.size()));
+    for (auto* param : params)
+        normalised.push_back(param->getDefaultValue());
+
+    for (int entry = 0; entry < count && ! in.isExhausted(); ++entry)
+    {
+        const auto id = in.readString();
+        const float value = in.readFloat();
+
+        // Entries are normally in parameter order, so try that slot before searching
+        for (int i = 0; i < params.size(); ++i)
+        {
+            const int index = (entry + i) % params.size();
+            if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(params[index]); ranged != nullptr && ranged->getParameterID() == id)
+            {
+                normalised[static_cast<size_t>(index)] = ranged->convertTo0to1(value);
+                break;
+            }
+        }
+    }
+
+    for (int i = 0; i < params.size(); ++i)
+        if (params[i]->getValue() != normalised[static_cast<size_t>(i)])
+            params[i]->setValueNotifyingHost(normalised[static_cast<size_t>(i)]);
+
+    return true;
+}
+
+std::shared_ptr<PresetBank::SharedLibrary> PresetBank::getSharedLibrary()
+{
+    const juce::ScopedLock sl(libraryLock);
+    static std::weak_ptr<SharedLibrary> shared;
+    if (auto existing = shared.lock())
+        return existing;
+
+    auto created = std::make_shared<Library>();
+    const std::pair<const char*, ParameterValues> factory[] = {
+        { "Init", {} },
+        { "Metallic Comb", makeFactoryValues({ { "filterType", 0 }, { "filterFreq", 220.0f }, { "feedback", 0.85f }, { "mix", 0.6f } }) },
+        { "Hollow Comb", makeFactoryValues({ { "filterType", 0 }, { "filterFreq", 440.0f }, { "feedback", -0.8f }, { "mix", 0.5f } }) },
+        { "FIR Smear", makeFactoryValues({ { "filterType", 1 }, { "taps", 32.0f }, { "tapGain", 0.8f }, { "filterFreq", 200.0f }, { "mix", 0.5f } }) },
+        { "Resonant Low-pass", makeFactoryValues({ { "filterType", 2 }, { "iirType", 0 }, { "iirSlope", 1 }, { "filterFreq", 800.0f }, { "iirQ", 6.0f }, { "mix", 1.0f } }) },
+        { "Slow Phaser", makeFactoryValues({ { "filterType", 3 }, { "filterFreq", 600.0f }, { "feedback", 0.8f }, { "lfoRate", 0.2f }, { "lfoDepth", 6.0f }, { "lfoStereo", 90.0f } }) },
+        { "Deep Phaser", makeFactoryValues({ { "filterType", 3 }, { "phaserStages", 3 }, { "phaserSpread", 0.6f }, { "phaserFeedback", 0.6f }, { "filterFreq", 800.0f },
+                                             { "feedback", 0.9f }, { "lfoRate", 0.15f }, { "lfoDepth", 8.0f }, { "lfoStereo", 90.0f } }) },
+        { "Wide Flanger", makeFactoryValues({ { "filterType", 4 }, { "filterFreq", 300.0f }, { "feedback", 0.7f }, { "lfoRate", 0.3f }, { "lfoDepth", 3.0f },
+                                              { "lfoStereo", 180.0f }, { "oversampling", 1 } }) },
+        { "Comb into Flanger", makeFactoryValues({ { "routing", 1 }, { "chainStage1", 1 }, { "chainStage2", 3 }, { "chainStage3", 5 }, { "chainStage4", 0 },
+                                                   { "filterFreq", 400.0f }, { "feedback", 0.6f }, { "iirType", 0 }, { "lfoRate", 0.2f }, { "lfoDepth", 2.0f } }) },
+    };
+
+    for (const auto& [name, values] : factory)
+    {
+        Preset preset{ name, {} };
+        writeValues(values, preset.state);
+        created->factory.push_back(std::move(preset));
+    }
+
+    created->user = scanUserPresets();
+    auto holder = std::make_shared<SharedLibrary>();
+    holder->current = std::move(created);
+    shared = holder;
+    return holder;
+}
+
+std::vector<PresetBank::Preset> PresetBank::scanUserPresets()
+{
+    std::vector<Preset> user;
+    for (const auto& file : getUserPresetFolder().findChildFiles(juce::File::findFiles, false, juce::String("*") + presetExtension))
+    {
+        Preset preset{ file.getFileNameWithoutExtension(), {} };
+        if (file.loadFileAsData(preset.state) && isBinaryState(preset.state.getData(), static_cast<int>(preset.state.getSize())))
+            user.push_back(std::move(preset));
+    }
+
+    std::sort(user.begin(), user.end(), [](const Preset& a, const Preset& b) { return a.name.compareNatural(b.name) < 0; });
+    return user;
+}
+
+std::shared_ptr<const PresetBank::Library> PresetBank::getLibrary() const
+{
+    return std::atomic_load(&library->current);
+}
+
+juce::File PresetBank::getUserPresetFolder()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("DelayFilterPlugin")
+        .getChildFile("Presets");
+}
+
+int PresetBank::getNumPresets() const noexcept
+{
+    const auto snapshot = getLibrary();
+    return static_cast<int>(snapshot->factory.size() + snapshot->user.size());
+}
+
+const PresetBank::Preset* PresetBank::getPreset(const Library& snapshot, int index) noexcept
+{
+    const int numFactory = static_cast<int>(snapshot.factory.size());
+    const int numUser = static_cast<int>(snapshot.user.size());
+    if (index >= 0 && index < numFactory)
+        return &snapshot.factory[static_cast<size_t>(index)];
+    if (index >= numFactory && index < numFactory + numUser)
+        return &snapshot.user[static_cast<size_t>(index - numFactory)];
+    return nullptr;
+}
+
+juce::String PresetBank::getPresetName(int index) const
+{
+    const auto snapshot = getLibrary();
+    const auto* preset = getPreset(*snapshot, index);
+    return preset != nullptr ? preset->name : juce::String();
+}
+
+bool PresetBank::loadPreset(int index)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+    const auto snapshot = getLibrary();
+    const auto* preset = getPreset(*snapshot, index);
+    if (preset == nullptr || ! readState(processor, preset->state.getData(), static_cast<int>(preset->state.getSize())))
+        return false;
+
+    currentPreset = index;
+    return true;
+}
+
+bool PresetBank::saveUserPreset(const juce::String& name)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+    const auto legalName = juce::File::createLegalFileName(name.trim());
+    const auto folder = getUserPresetFolder();
+    if (legalName.isEmpty() || ! folder.createDirectory())
+        return false;
+
+    juce::MemoryBlock state;
+    writeState(processor, state);
+    if (! folder.getChildFile(legalName + presetExtension).replaceWithData(state.getData(), state.getSize()))
+        return false;
+
+    // Other instances see the new preset too: they pick up the rescanned copy on their next read,
+    // while anything holding the old one keeps it
+    auto rescanned = std::make_shared<Library>();
+    rescanned->factory = getLibrary()->factory;
+    rescanned->user = scanUserPresets();
+    for (size_t i = 0; i < rescanned->user.size(); ++i)
+        if (rescanned->user[i].name == legalName)
+            currentPreset = static_cast<int>(rescanned->factory.size() + i);
+
+    std::atomic_store(&library->current, std::shared_ptr<const Library>(std::move(rescanned)));
+
+    return true;
+}
\ No newline at end of file
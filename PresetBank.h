@@ -0,0 +1,63 @@
+// === File: PresetBank.h ===
+#pragma once
+
+#include <JuceHeader.h>
+
+// Plugin state and presets. The state format is a flat, versioned list of
+// (parameter ID, plain value) pairs, written and read without going through XML; blobs that
+// don't carry its header are left to the caller's XML fallback.
+//
+// The bank lists the built-in factory presets followed by the user presets saved in the user
+// preset folder (shared by every instance in the process and scanned once; a save publishes a
+// rescanned copy, so another instance never sees the list change under it). Loading a preset
+// runs on the message thread and only stores new parameter values, which the audio thread
+// picks up at its next block, continuous ones through their smoothers.
+class PresetBank
+{
+public:
+    explicit PresetBank(juce::AudioProcessor& processorToControl);
+
+    static void writeState(const juce::AudioProcessor& processor, juce::MemoryBlock& destData);
+    static bool isBinaryState(const void* data, int sizeInBytes) noexcept;
+    // Parameters the blob doesn't mention are reset to their defaults
+    static bool readState(juce::AudioProcessor& processor, const void* data, int sizeInBytes);
+
+    int getNumPresets() const noexcept;
+    juce::String getPresetName(int index) const;
+    int getCurrentPreset() const noexcept { return currentPreset; }
+    bool loadPreset(int index);
+
+    // Saves the current values as a user preset (replacing one of the same name) and selects it
+    bool saveUserPreset(const juce::String& name);
+    static juce::File getUserPresetFolder();
+
+private:
+    struct Preset
+    {
+        juce::String name;
+        juce::MemoryBlock state;
+    };
+
+    // Never modified once published: readers work on the snapshot they loaded
+    struct Library
+    {
+        std::vector<Preset> factory, user;
+    };
+
+    // Holds the current Library; only read and replaced through std::atomic_load / atomic_store
+    struct SharedLibrary
+    {
+        std::shared_ptr<const Library> current;
+    };
+
+    static std::shared_ptr<SharedLibrary> getSharedLibrary();
+    static std::vector<Preset> scanUserPresets();
+    std::shared_ptr<const Library> getLibrary() const;
+    static const Preset* getPreset(const Library& snapshot, int index) noexcept;
+
+    juce::AudioProcessor& processor;
+    std::shared_ptr<SharedLibrary> library;
+    int currentPreset{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE(PresetBank)
+};
\ No newline at end of file
@@ -0,0 +1,183 @@
+// === File: RealtimeGuard.cpp ===
+#include "RealtimeGuard.h"
+
+#if DFP_REALTIME_GUARD
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#if JUCE_WINDOWS
+ #include <malloc.h>
+#endif
+
+#if JUCE_LINUX
+ #include <dlfcn.h>
+ #include <pthread.h>
+#endif
+
+namespace
+{
+    // Plain thread_locals of trivial type: no guard variables, no allocation on first access.
+    thread_local int realtimeDepth = 0;
+    thread_local int disableDepth = 0;
+    std::atomic<int> violationCount{ 0 };
+
+    inline bool shouldTrap() noexcept
+    {
+        return realtimeDepth > 0 && disableDepth == 0;
+    }
+}
+
+namespace RealtimeGuard
+{
+    ScopedRealtimeSection::ScopedRealtimeSection() noexcept { ++realtimeDepth; }
+    ScopedRealtimeSection::~ScopedRealtimeSection() noexcept { --realtimeDepth; }
+
+    ScopedDisable::ScopedDisable() noexcept { ++disableDepth; }
+    ScopedDisable::~ScopedDisable() noexcept { --disableDepth; }
+
+    bool isInRealtimeSection() noexcept { return shouldTrap(); }
+
+    int getViolationCount() noexcept { return violationCount.load(std::memory_order_relaxed); }
+
+    void reportViolation(const char* what) noexcept
+    {
+        // Disarm while reporting so stdio/assert machinery can't recurse into the hooks.
+        ++disableDepth;
+        violationCount.fetch_add(1, std::memory_order_relaxed);
+        std::fputs("DelayFilterPlugin: real-time violation in processBlock: ", stderr);
+        std::fputs(what, stderr);
+        std::fputs("\n", stderr);
+        jassertfalse;
+#if DFP_REALTIME_GUARD_FATAL
+        std::abort();
+#endif
+        --disableDepth;
+    }
+}
+
+//==============================================================================
+// Global allocator hooks, plain and aligned
+static void* guardedAlloc(std::size_t size, const char* what)
+{
+    if (shouldTrap())
+        RealtimeGuard::reportViolation(what);
+
+    if (void* p = std::malloc(size == 0 ? 1 : size))
+        return p;
+    throw std::bad_alloc();
+}
+
+static void guardedFree(void* p, const char* what) noexcept
+{
+    if (p != nullptr && shouldTrap())
+        RealtimeGuard::reportViolation(what);
+    std::free(p);
+}
+
+void* operator new(std::size_t size) { return guardedAlloc(size, "operator new"); }
+void* operator new[](std::size_t size) { return guardedAlloc(size, "operator new[]"); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    if (shouldTrap())
+        RealtimeGuard::reportViolation("operator new (nothrow)");
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    if (shouldTrap())
+        RealtimeGuard::reportViolation("operator new[] (nothrow)");
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+// Over-aligned types (alignas above the default new alignment) come through these
+static void* guardedAlignedAlloc(std::size_t size, std::align_val_t alignment, const char* what) noexcept
+{
+    if (shouldTrap())
+        RealtimeGuard::reportViolation(what);
+
+    const auto align = juce::jmax(sizeof(void*), static_cast<std::size_t>(alignment));
+   #if JUCE_WINDOWS
+    return _aligned_malloc(size == 0 ? 1 : size, align);
+   #else
+    void* p = nullptr;
+    return posix_memalign(&p, align, size == 0 ? 1 : size) == 0 ? p : nullptr;
+   #endif
+}
+
+static void guardedAlignedFree(void* p, const char* what) noexcept
+{
+    if (p != nullptr && shouldTrap())
+        RealtimeGuard::reportViolation(what);
+   #if JUCE_WINDOWS
+    _aligned_free(p);
+   #else
+    std::free(p);
+   #endif
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    if (void* p = guardedAlignedAlloc(size, alignment, "operator new (aligned)"))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    if (void* p = guardedAlignedAlloc(size, alignment, "operator new[] (aligned)"))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return guardedAlignedAlloc(size, alignment, "operator new (aligned, nothrow)");
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return guardedAlignedAlloc(size, alignment, "operator new[] (aligned, nothrow)");
+}
+
+void operator delete(void* p) noexcept { guardedFree(p, "operator delete"); }
+void operator delete[](void* p) noexcept { guardedFree(p, "operator delete[]"); }
+void operator delete(void* p, std::size_t) noexcept { guardedFree(p, "operator delete"); }
+void operator delete[](void* p, std::size_t) noexcept { guardedFree(p, "operator delete[]"); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { guardedFree(p, "operator delete"); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { guardedFree(p, "operator delete[]"); }
+void operator delete(void* p, std::align_val_t) noexcept { guardedAlignedFree(p, "operator delete (aligned)"); }
+void operator delete[](void* p, std::align_val_t) noexcept { guardedAlignedFree(p, "operator delete[] (aligned)"); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { guardedAlignedFree(p, "operator delete (aligned)"); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { guardedAlignedFree(p, "operator delete[] (aligned)"); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { guardedAlignedFree(p, "operator delete (aligned)"); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { guardedAlignedFree(p, "operator delete[] (aligned)"); }
+
+//==============================================================================
+// Lock hook. Only takes effect where the definition can interpose (executables such as
+// the benchmark/test tools); inside a dlopen'ed plugin the host's libc wins symbol lookup.
+#if JUCE_LINUX
+extern "C" int pthread_mutex_lock(pthread_mutex_t* mutex)
+{
+    using LockFn = int (*)(pthread_mutex_t*);
+    static std::atomic<LockFn> realLock{ nullptr };
+
+    auto fn = realLock.load(std::memory_order_acquire);
+    if (fn == nullptr)
+    {
+        fn = reinterpret_cast<LockFn>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+        realLock.store(fn, std::memory_order_release);
+    }
+
+    if (shouldTrap())
+        RealtimeGuard::reportViolation("pthread_mutex_lock");
+
+    return fn(mutex);
+}
+#endif
+
+#endif // DFP_REALTIME_GUARD
\ No newline at end of file
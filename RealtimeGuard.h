@@ -0,0 +1,50 @@
+// === File: RealtimeGuard.h ===
+#pragma once
+
+#include <JuceHeader.h>
+
+// Test guard that traps heap allocations and mutex locks made while processBlock is running.
+// It replaces the global operator new/delete and interposes pthread_mutex_lock, which must not
+// happen inside a plugin loaded into a host, so it is off unless the target defines
+// DFP_REALTIME_GUARD=1 (the benchmark does). Define DFP_REALTIME_GUARD_FATAL=1 as well to abort
+// on the first violation.
+#ifndef DFP_REALTIME_GUARD
+ #define DFP_REALTIME_GUARD 0
+#endif
+
+#ifndef DFP_REALTIME_GUARD_FATAL
+ #define DFP_REALTIME_GUARD_FATAL 0
+#endif
+
+namespace RealtimeGuard
+{
+#if DFP_REALTIME_GUARD
+    // Marks the calling thread as real-time for the lifetime of the object (nestable).
+    struct ScopedRealtimeSection
+    {
+        ScopedRealtimeSection() noexcept;
+        ~ScopedRealtimeSection() noexcept;
+    };
+
+    // Suspends the guard on this thread, for code that is known to be allowed to allocate.
+    struct ScopedDisable
+    {
+        ScopedDisable() noexcept;
+        ~ScopedDisable() noexcept;
+    };
+
+    bool isInRealtimeSection() noexcept;
+
+    // Called by the allocator/lock hooks; prints the offence, asserts, and aborts in fatal mode.
+    void reportViolation(const char* what) noexcept;
+
+    // Number of violations seen since start-up (all threads).
+    int getViolationCount() noexcept;
+#else
+    struct ScopedRealtimeSection { ScopedRealtimeSection() noexcept {} };
+    struct ScopedDisable { ScopedDisable() noexcept {} };
+
+    inline bool isInRealtimeSection() noexcept { return false; }
+    inline int getViolationCount() noexcept { return 0; }
+#endif
+}
\ No newline at end of file
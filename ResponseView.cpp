@@ -0,0 +1,141 @@
+// === File: ResponseView.cpp ===
+#include "ResponseView.h"
+
+ResponseView::ResponseView(DelayFilterPluginAudioProcessor& p)
+    : audioProcessor(p), fftData(static_cast<size_t>(2 * SpectrumFeed::historySize), 0.0f)
+{
+    spectrumDb.fill(minSpectrumDb);
+    spectrumButton.onClick = [this]
+        {
+            audioProcessor.getSpectrumFeed().setActive(spectrumButton.getToggleState());
+            spectrumDb.fill(minSpectrumDb);
+            spectrumPath.clear();
+            repaint();
+        };
+    addAndMakeVisible(spectrumButton);
+
+    // Curves only change with parameters or the LFO; 20 Hz is plenty for either
+    startTimerHz(20);
+}
+
+ResponseView::~ResponseView()
+{
+    audioProcessor.getSpectrumFeed().setActive(false);
+}
+
+void ResponseView::timerCallback()
+{
+    if (response.update(audioProcessor.getResponseSettings()))
+    {
+        rebuildResponsePaths();
+        repaint();
+    }
+
+    if (spectrumButton.getToggleState() && audioProcessor.getSpectrumFeed().pull())
+    {
+        updateSpectrum();
+        repaint();
+    }
+}
+
+juce::Path ResponseView::makeCurve(const float* values, float minValue, float maxValue, bool closed)
+{
+    constexpr int n = FilterResponse::numPoints;
+    const auto plot = getLocalBounds().toFloat().reduced(2.0f);
+    const float scale = plot.getHeight() / (maxValue - minValue);
+
+    // y = top + (maxValue - v) * scale, for the whole curve at once
+    float* y = curveY.data();
+    juce::FloatVectorOperations::clip(y, values, minValue, maxValue, n);
+    juce::FloatVectorOperations::multiply(y, -scale, n);
+    juce::FloatVectorOperations::add(y, plot.getY() + maxValue * scale, n);
+
+    // The grid is log-spaced in frequency, so it is evenly spaced along the x axis
+    const float dx = plot.getWidth() / static_cast<float>(n - 1);
+    juce::Path path;
+    path.preallocateSpace(3 * n + 8);
+    path.startNewSubPath(plot.getX(), y[0]);
+    for (int i = 1; i < n; ++i)
+        path.lineTo(plot.getX() + dx * static_cast<float>(i), y[i]);
+
+    if (closed)
+    {
+        path.lineTo(plot.getRight(), plot.getBottom());
+        path.lineTo(plot.getX(), plot.getBottom());
+        path.closeSubPath();
+    }
+    return path;
+}
+
+void ResponseView::rebuildResponsePaths()
+{
+    magnitudePath = makeCurve(response.getMagnitudeDb(), minDb, maxDb, false);
+    phasePath = makeCurve(response.getPhase(), -juce::MathConstants<float>::pi, juce::MathConstants<float>::pi, false);
+}
+
+void ResponseView::updateSpectrum()
+{
+    constexpr int size = SpectrumFeed::historySize;
+    std::copy_n(audioProcessor.getSpectrumFeed().getHistory(), size, fftData.begin());
+    std::fill(fftData.begin() + size, fftData.end(), 0.0f);
+    window.multiplyWithWindowingTable(fftData.data(), static_cast<size_t>(size));
+    fft.performFrequencyOnlyForwardTransform(fftData.data(), true);
+
+    // Sample the bins at the response grid; a full-scale sine reads about 0 dBFS (the Hann
+    // window's coherent gain is 0.5). The display falls back slowly rather than flickering.
+    const double binsPerHz = size / juce::jmax(1.0, audioProcessor.getSampleRate());
+    const float normalise = 4.0f / static_cast<float>(size);
+    for (int point = 0; point < FilterResponse::numPoints; ++point)
+    {
+        const double bin = juce::jmin(response.getFrequency(point) * binsPerHz, size / 2.0 - 1.0);
+        const int index = static_cast<int>(bin);
+        const float frac = static_cast<float>(bin - index);
+        const float magnitude = fftData[static_cast<size_t>(index)] + frac * (fftData[static_cast<size_t>(index + 1)] - fftData[static_cast<size_t>(index)]);
+        const float db = juce::Decibels::gainToDecibels(magnitude * normalise, minSpectrumDb);
+        auto& shown = spectrumDb[static_cast<size_t>(point)];
+        shown = juce::jmax(db, shown - 3.0f);
+    }
+
+    spectrumPath = makeCurve(spectrumDb.data(), minSpectrumDb, maxSpectrumDb, true);
+}
+
+void ResponseView::paint(juce::Graphics& g)
+{
+    const auto plot = getLocalBounds().toFloat().reduced(2.0f);
+    g.setColour(juce::Colours::black.withAlpha(0.3f));
+    g.fillRect(plot);
+
+    // Grid: decades and the 0 dB line
+    g.setFont(10.0f);
+    for (double hz : { 100.0, 1000.0, 10000.0 })
+    {
+        const float x = plot.getX() + plot.getWidth() * static_cast<float>(std::log(hz / FilterResponse::minHz) / std::log(FilterResponse::maxHz / FilterResponse::minHz));
+        g.setColour(juce::Colours::white.withAlpha(0.15f));
+        g.drawVerticalLine(juce::roundToInt(x), plot.getY(), plot.getBottom());
+        g.setColour(juce::Colours::white.withAlpha(0.5f));
+        g.drawText(hz >= 1000.0 ? juce::String(hz / 1000.0) + "k" : juce::String(hz), juce::roundToInt(x) + 2, juce::roundToInt(plot.getBottom()) - 14, 30, 12,
+                   juce::Justification::centredLeft);
+    }
+    const float zeroDbY = plot.getY() + plot.getHeight() * maxDb / (maxDb - minDb);
+    g.setColour(juce::Colours::white.withAlpha(0.25f));
+    g.drawHorizontalLine(juce::roundToInt(zeroDbY), plot.getX(), plot.getRight());
+
+    if (spectrumButton.getToggleState())
+    {
+        g.setColour(juce::Colours::skyblue.withAlpha(0.25f));
+        g.fillPath(spectrumPath);
+    }
+
+    g.setColour(juce::Colours::orange.withAlpha(0.35f));
+    g.strokePath(phasePath, juce::PathStrokeType(1.0f));
+    g.setColour(juce::Colours::limegreen);
+    g.strokePath(magnitudePath, juce::PathStrokeType(2.0f));
+}
+
+void ResponseView::resized()
+{
+    spectrumButton.setBounds(getLocalBounds().removeFromTop(24).removeFromRight(100).reduced(2));
+    rebuildResponsePaths();
+    if (spectrumButton.getToggleState())
+        spectrumPath = makeCurve(spectrumDb.data(), minSpectrumDb, maxSpectrumDb, true);
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+// === File: ResponseView.h ===
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+// Editor view of the current mode's magnitude (and, faintly, phase) response, computed
+// analytically by FilterResponse on the message thread and cached as paths until a parameter,
+// or in Phaser/Flanger the LFO position, changes. The optional spectrum shows the post-FX
+// output from the processor's SpectrumFeed; the audio thread only feeds it while it is on.
+class ResponseView : public juce::Component,
+                     private juce::Timer
+{
+public:
+    explicit ResponseView(DelayFilterPluginAudioProcessor&);
+    ~ResponseView() override;
+
+    void paint(juce::Graphics&) override;
+    void resized() override;
+
+private:
+    void timerCallback() override;
+    void rebuildResponsePaths();
+    void updateSpectrum();
+
+    // Maps values (clipped to [minValue, maxValue]) onto the plot, one point per grid frequency
+    juce::Path makeCurve(const float* values, float minValue, float maxValue, bool closed);
+
+    static constexpr float minDb = -36.0f, maxDb = 24.0f;                // response scale
+    static constexpr float minSpectrumDb = -96.0f, maxSpectrumDb = 0.0f; // spectrum scale, dBFS
+    static constexpr int fftOrder = 11;
+    static_assert((1 << fftOrder) == SpectrumFeed::historySize, "one FFT frame per feed history");
+
+    DelayFilterPluginAudioProcessor& audioProcessor;
+    FilterResponse response;
+    juce::ToggleButton spectrumButton{ "Spectrum" };
+
+    juce::dsp::FFT fft{ fftOrder };
+    juce::dsp::WindowingFunction<float> window{ static_cast<size_t>(SpectrumFeed::historySize), juce::dsp::WindowingFunction<float>::hann };
+    std::vector<float> fftData;
+    std::array<float, FilterResponse::numPoints> spectrumDb{}, curveY{};
+
+    juce::Path magnitudePath, phasePath, spectrumPath;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ResponseView)
+};
\ No newline at end of file
@@ -0,0 +1,89 @@
+// === File: SmoothedParameter.h ===
+#pragma once
+
+#include <JuceHeader.h>
+
+// Block-rate smoothing for one continuous parameter. Reads the cached APVTS atomic once per
+// block and renders a per-sample linear ramp toward it, so kernels can apply the value with
+// FloatVectorOperations. While settled, the ramp is a constant fill and isSmoothing() is false,
+// which lets kernels keep their static fast paths.
+class SmoothedParameter
+{
+public:
+    void attach(std::atomic<float>* parameterSource) noexcept { source = parameterSource; }
+
+    void prepare(double sampleRate, double rampSeconds, int maxBlockSize)
+    {
+        rampLength = juce::jmax(1, static_cast<int>(sampleRate * rampSeconds));
+        ramp.assign(static_cast<size_t>(juce::jmax(1, maxBlockSize)), 0.0f);
+        current = target = source != nullptr ? source->load() : 0.0f;
+        stepsRemaining = 0;
+        smoothing = false;
+        juce::FloatVectorOperations::fill(ramp.data(), current, static_cast<int>(ramp.size()));
+    }
+
+    // Advances by numSamples and returns the per-sample values for the block
+    const float* process(int numSamples) noexcept
+    {
+        jassert(numSamples <= static_cast<int>(ramp.size()));
+        updateTarget();
+
+        float* r = ramp.data();
+        smoothing = stepsRemaining > 0;
+
+        if (! smoothing)
+        {
+            juce::FloatVectorOperations::fill(r, current, numSamples);
+            return r;
+        }
+
+        const int len = juce::jmin(numSamples, stepsRemaining);
+        const float start = current;
+        for (int i = 0; i < len; ++i)
+            r[i] = start + step * static_cast<float>(i + 1);
+
+        stepsRemaining -= len;
+        current = stepsRemaining > 0 ? r[len - 1] : target;
+        if (len < numSamples)
+            juce::FloatVectorOperations::fill(r + len, current, numSamples - len);
+
+        return r;
+    }
+
+    // Advances by numSamples without rendering the ramp (idle blocks)
+    void skip(int numSamples) noexcept
+    {
+        updateTarget();
+        const int len = juce::jmin(numSamples, stepsRemaining);
+        stepsRemaining -= len;
+        current = stepsRemaining > 0 ? current + step * static_cast<float>(len) : target;
+        smoothing = false;
+    }
+
+    const float* getRamp() const noexcept { return ramp.data(); }
+
+    // True if the last processed block was not a constant
+    bool isSmoothing() const noexcept { return smoothing; }
+
+    // Value reached at the end of the last processed block
+    float getCurrentValue() const noexcept { return current; }
+
+private:
+    void updateTarget() noexcept
+    {
+        const float newTarget = source->load();
+        if (newTarget != target)
+        {
+            target = newTarget;
+            stepsRemaining = rampLength;
+            step = (target - current) / static_cast<float>(rampLength);
+        }
+    }
+
+    std::atomic<float>* source{ nullptr };
+    std::vector<float> ramp;
+    float current{ 0.0f }, target{ 0.0f }, step{ 0.0f };
+    int rampLength{ 1 };
+    int stepsRemaining{ 0 };
+    bool smoothing{ false };
+};
\ No newline at end of file
@@ -0,0 +1,101 @@
+// === File: SpectrumFeed.h ===
+#pragma once
+
+#include <JuceHeader.h>
+
+// Post-FX samples for the editor's spectrum display. While a view has switched it on, the
+// audio thread writes the mono sum of the first two channels into a single-producer
+// AbstractFifo, dropping whatever doesn't fit (so it never waits); the message thread drains
+// it into a history of the last historySize samples at its own, low rate.
+// The buffers are only allocated once a view first switches the feed on, sized for the sample
+// rate; prepare() resizes them, or frees them while no view is using the feed.
+class SpectrumFeed
+{
+public:
+    static constexpr int historySize = 2048;
+
+    // Call while the audio thread is stopped
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        if (isActive())
+            allocate();
+        else
+            release();
+    }
+
+    // Message thread
+    void setActive(bool shouldBeActive)
+    {
+        if (shouldBeActive && samples.empty())
+            allocate();
+        active.store(shouldBeActive, std::memory_order_release);
+    }
+
+    bool isActive() const noexcept { return active.load(std::memory_order_acquire); }
+
+    // Audio thread
+    template <typename SampleType>
+    void push(const SampleType* const* channels, int numChannels, int numSamples) noexcept
+    {
+        if (! isActive() || numChannels <= 0)
+            return;
+
+        const auto scope = fifo.write(numSamples); // clamped to the free space
+        const SampleType* right = channels[juce::jmin(1, numChannels - 1)];
+        int source = 0;
+        auto copy = [&](int start, int count)
+            {
+                for (int i = 0; i < count; ++i, ++source)
+                    samples[static_cast<size_t>(start + i)] = 0.5f * static_cast<float>(channels[0][source] + right[source]);
+            };
+        copy(scope.startIndex1, scope.blockSize1);
+        copy(scope.startIndex2, scope.blockSize2);
+    }
+
+    // Message thread: appends everything queued to the history; returns true if anything arrived
+    bool pull() noexcept
+    {
+        const int ready = fifo.getNumReady();
+        if (ready == 0)
+            return false;
+
+        // Only the newest historySize samples can matter
+        const int keep = juce::jmin(ready, historySize);
+        fifo.read(ready - keep); // discarded
+        std::move(history.begin() + keep, history.end(), history.begin());
+
+        const auto scope = fifo.read(keep);
+        float* dest = history.data() + historySize - keep;
+        std::copy_n(samples.data() + scope.startIndex1, scope.blockSize1, dest);
+        std::copy_n(samples.data() + scope.startIndex2, scope.blockSize2, dest + scope.blockSize1);
+        return true;
+    }
+
+    // Oldest first
+    const float* getHistory() const noexcept { return history.data(); }
+
+private:
+    void allocate()
+    {
+        // Comfortably more than one editor tick (0.1 s) of samples
+        const int fifoSize = juce::nextPowerOfTwo(static_cast<int>(std::ceil(sampleRate * 0.15)) + 1);
+        samples.assign(static_cast<size_t>(fifoSize), 0.0f);
+        history.assign(static_cast<size_t>(historySize), 0.0f);
+        fifo.setTotalSize(fifoSize);
+        fifo.reset();
+    }
+
+    void release()
+    {
+        std::vector<float>().swap(samples);
+        std::vector<float>().swap(history);
+        fifo.setTotalSize(1);
+        fifo.reset();
+    }
+
+    juce::AbstractFifo fifo{ 1 }; // holds nothing until allocated
+    std::vector<float> samples, history;
+    double sampleRate{ 44100.0 };
+    std::atomic<bool> active{ false };
+};
\ No newline at end of file
@@ -0,0 +1,204 @@
+// === File: StateVariableFilter.h ===
+#pragma once
+
+#include <JuceHeader.h>
+#include <complex>
+
+// Topology-preserving-transform state-variable filter for the IIR mode. Cutoff and Q may
+// change every sample: the warped gain g = tan(pi * f / fs) comes from a lookup table and the
+// remaining coefficients are a handful of multiplies, so nothing is rebuilt or allocated.
+// One or two cascaded sections give 12 or 24 dB/oct; channels are packed into SIMD lanes so
+// a stereo (or wider) bus runs through a single set of vector operations. State and
+// coefficients are in the processing precision.
+enum class SvfType { lowPass = 0, highPass, bandPass };
+
+template <typename SampleType>
+class StateVariableFilter
+{
+public:
+    using Type = SvfType;
+
+    static constexpr int maxStages = 2;
+
+    void prepare(double newSampleRate, int numChannels, int maxBlockSize)
+    {
+        sampleRate = newSampleRate;
+        numGroups = (numChannels + lanes - 1) / lanes;
+        state.assign(static_cast<size_t>(numGroups * maxStages * 2), Vec());
+        coeffs.setSize(numCoeffRows, maxBlockSize);
+        getTanTable(); // build the shared table off the audio thread
+        reset();
+    }
+
+    void reset()
+    {
+        std::fill(state.begin(), state.end(), Vec::expand(SampleType(0)));
+    }
+
+    // Seconds for the impulse response envelope (exp(-pi * f * t / Q) per section) to fall to level
+    static double getDecaySeconds(double cutoffHz, double q, int stages, double level) noexcept
+    {
+        const double maxQ = stages > 1 ? juce::jmax(static_cast<double>(stage1Q), q * stage2QScale) : q;
+        return stages * -std::log(level) * maxQ / (juce::MathConstants<double>::pi * juce::jmax(1.0, cutoffHz));
+    }
+
+    // Exact response at freqHz: the TPT structure is the bilinear transform of the analog
+    // prototype, so H(z) is the prototype evaluated at s = j tan(pi f / fs) / g
+    static std::complex<double> getResponse(Type filterType, double cutoffHz, double q, int stages, double freqHz, double sampleRate) noexcept
+    {
+        const double g = std::tan(juce::MathConstants<double>::pi * juce::jlimit(0.0, static_cast<double>(maxNormalisedFreq), cutoffHz / sampleRate));
+        const std::complex<double> s(0.0, std::tan(juce::MathConstants<double>::pi * juce::jmin(0.4999, freqHz / sampleRate)) / juce::jmax(1.0e-9, g));
+
+        std::complex<double> h(1.0, 0.0);
+        for (int stage = 0; stage < stages; ++stage)
+        {
+            const double stageQ = stages == 2 ? (stage == 0 ? static_cast<double>(stage1Q) : q * stage2QScale) : q;
+            const double k = 1.0 / stageQ;
+            const auto denominator = s * s + k * s + 1.0;
+
+            if (filterType == Type::lowPass)
+                h *= 1.0 / denominator;
+            else if (filterType == Type::highPass)
+                h *= s * s / denominator;
+            else
+                h *= k * s / denominator;
+        }
+        return h;
+    }
+
+    void setType(Type newType) noexcept { type = newType; }
+    void setNumStages(int stages) noexcept { numStages = juce::jlimit(1, maxStages, stages); }
+
+    // Filters channels in place; cutoffHz and q hold one value per sample
+    void process(SampleType* const* channels, int numChannels, const float* cutoffHz, const float* q, int numSamples) noexcept
+    {
+        jassert(numSamples <= coeffs.getNumSamples());
+        computeCoefficients(cutoffHz, q, numSamples);
+
+        for (int group = 0; group < numGroups; ++group)
+        {
+            const int firstChannel = group * lanes;
+            const int groupChannels = juce::jmin(lanes, numChannels - firstChannel);
+            if (groupChannels <= 0)
+                break;
+
+            switch (type)
+            {
+            case Type::lowPass:  processGroup<Type::lowPass>(channels + firstChannel, groupChannels, group, numSamples); break;
+            case Type::highPass: processGroup<Type::highPass>(channels + firstChannel, groupChannels, group, numSamples); break;
+            case Type::bandPass: processGroup<Type::bandPass>(channels + firstChannel, groupChannels, group, numSamples); break;
+            }
+        }
+    }
+
+private:
+    using Vec = juce::dsp::SIMDRegister<SampleType>;
+    static constexpr int lanes = static_cast<int>(Vec::size());
+
+    // Per stage: k, a1, a2, a3
+    static constexpr int numCoeffRows = maxStages * 4;
+
+    // 24 dB mode: Butterworth split, scaled so the default Q of 0.707 gives a flat 4th order
+    static constexpr float stage1Q = 0.5412f;
+    static constexpr float stage2QScale = 1.3066f / 0.7071f;
+
+    static constexpr int tanTableSize = 4096;
+    static constexpr float maxNormalisedFreq = 0.49f;
+    using TanTable = std::array<float, tanTableSize + 2>;
+
+    // g = tan(pi * f / fs) over f / fs in [0, 0.5)
+    static const TanTable& getTanTable()
+    {
+        static const TanTable table = []
+        {
+            TanTable t{};
+            for (int i = 0; i < tanTableSize + 2; ++i)
+                t[static_cast<size_t>(i)] = static_cast<float>(std::tan(juce::MathConstants<double>::pi * juce::jmin(0.499, 0.5 * i / tanTableSize)));
+            return t;
+        }();
+        return table;
+    }
+
+    void computeCoefficients(const float* cutoffHz, const float* q, int numSamples) noexcept
+    {
+        const auto& table = getTanTable();
+        const float toIndex = static_cast<float>(2.0 * tanTableSize / sampleRate);
+        const float maxIndex = maxNormalisedFreq * 2.0f * tanTableSize;
+
+        for (int stage = 0; stage < numStages; ++stage)
+        {
+            SampleType* kRow = coeffs.getWritePointer(stage * 4 + 0);
+            SampleType* a1Row = coeffs.getWritePointer(stage * 4 + 1);
+            SampleType* a2Row = coeffs.getWritePointer(stage * 4 + 2);
+            SampleType* a3Row = coeffs.getWritePointer(stage * 4 + 3);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const float pos = juce::jlimit(0.0f, maxIndex, cutoffHz[i] * toIndex);
+                const int idx = static_cast<int>(pos);
+                const auto frac = static_cast<SampleType>(pos - static_cast<float>(idx));
+                const auto g0 = static_cast<SampleType>(table[static_cast<size_t>(idx)]);
+                const SampleType g = g0 + frac * (static_cast<SampleType>(table[static_cast<size_t>(idx + 1)]) - g0);
+
+                float stageQ = q[i];
+                if (numStages == 2)
+                    stageQ = (stage == 0) ? stage1Q : q[i] * stage2QScale;
+
+                const SampleType k = SampleType(1) / static_cast<SampleType>(stageQ);
+                const SampleType a1 = SampleType(1) / (SampleType(1) + g * (g + k));
+                kRow[i] = k;
+                a1Row[i] = a1;
+                a2Row[i] = g * a1;
+                a3Row[i] = g * g * a1;
+            }
+        }
+    }
+
+    template <Type filterType>
+    void processGroup(SampleType* const* channels, int groupChannels, int group, int numSamples) noexcept
+    {
+        alignas(Vec::SIMDRegisterSize) SampleType io[lanes] = {};
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            for (int ch = 0; ch < groupChannels; ++ch)
+                io[ch] = channels[ch][i];
+
+            Vec x = Vec::fromRawArray(io);
+
+            for (int stage = 0; stage < numStages; ++stage)
+            {
+                Vec& ic1 = state[static_cast<size_t>((group * maxStages + stage) * 2)];
+                Vec& ic2 = state[static_cast<size_t>((group * maxStages + stage) * 2 + 1)];
+                const SampleType k = coeffs.getSample(stage * 4 + 0, i);
+                const SampleType a1 = coeffs.getSample(stage * 4 + 1, i);
+                const SampleType a2 = coeffs.getSample(stage * 4 + 2, i);
+                const SampleType a3 = coeffs.getSample(stage * 4 + 3, i);
+
+                const Vec v3 = x - ic2;
+                const Vec v1 = ic1 * a1 + v3 * a2;
+                const Vec v2 = ic2 + ic1 * a2 + v3 * a3;
+                ic1 = v1 + v1 - ic1;
+                ic2 = v2 + v2 - ic2;
+
+                if constexpr (filterType == Type::lowPass)
+                    x = v2;
+                else if constexpr (filterType == Type::highPass)
+                    x = x - v1 * k - v2;
+                else
+                    x = v1 * k; // unity peak gain, matching the RBJ band-pass
+            }
+
+            x.copyToRawArray(io);
+            for (int ch = 0; ch < groupChannels; ++ch)
+                channels[ch][i] = io[ch];
+        }
+    }
+
+    double sampleRate{ 44100.0 };
+    Type type{ Type::lowPass };
+    int numStages{ 1 };
+    int numGroups{ 0 };
+    std::vector<Vec> state; // ic1/ic2 per (group, stage)
+    juce::AudioBuffer<SampleType> coeffs;
+};
\ No newline at end of file